@@ -0,0 +1,116 @@
+#ifndef BITSET_H
+#define BITSET_H
+
+// bitsets as arrays of 64-bit words: bit i of a set is (words[i / 64] >> (i % 64)) & 1.
+// The kernels on long rows are dispatched to the best instruction set of the CPU (SetKernels.h).
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+#include "SetKernels.h"
+
+// allocator for cache line (64 byte) aligned bitset rows
+template <typename T, size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U> struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* p, size_t) {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U> bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <typename U> bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+typedef std::vector<uint64_t, AlignedAllocator<uint64_t>> BitsetVector;
+
+// number of 64-bit words needed for n bits
+inline size_t bitset_words(size_t n) {
+    return (n + 63) / 64;
+}
+
+// number of 64-bit words needed for n bits, rounded up to full cache lines (8 words)
+inline size_t bitset_words_aligned(size_t n) {
+    return (bitset_words(n) + 7) / 8 * 8;
+}
+
+inline bool bitset_test(const uint64_t* a, int i) {
+    return (a[i >> 6] >> (i & 63)) & 1;
+}
+inline void bitset_set(uint64_t* a, int i) {
+    a[i >> 6] |= uint64_t(1) << (i & 63);
+}
+inline void bitset_reset(uint64_t* a, int i) {
+    a[i >> 6] &= ~(uint64_t(1) << (i & 63));
+}
+
+// rows with fewer words than this (i.e. single-word rows of graphs with n <= 64) use inline loops,
+// longer rows the kernels selected at startup (see SetKernels.h)
+#define BITSET_KERNEL_MIN_WORDS 8
+
+// result = a \cap b
+inline void bitset_and(uint64_t* result, const uint64_t* a, const uint64_t* b, size_t words) {
+    if(words >= BITSET_KERNEL_MIN_WORDS) return setKernels.bitset_and(result, a, b, words);
+    for(size_t i=0; i < words; ++i) result[i] = a[i] & b[i];
+}
+
+// result = a \setminus b
+inline void bitset_andnot(uint64_t* result, const uint64_t* a, const uint64_t* b, size_t words) {
+    if(words >= BITSET_KERNEL_MIN_WORDS) return setKernels.bitset_andnot(result, a, b, words);
+    for(size_t i=0; i < words; ++i) result[i] = a[i] & ~b[i];
+}
+
+// |a|
+inline size_t bitset_count(const uint64_t* a, size_t words) {
+    if(words >= BITSET_KERNEL_MIN_WORDS) return setKernels.bitset_count(a, words);
+    size_t count = 0;
+    for(size_t i=0; i < words; ++i) count += __builtin_popcountll(a[i]);
+    return count;
+}
+
+// |a \cap b| without writing the intersection
+inline size_t bitset_and_count(const uint64_t* a, const uint64_t* b, size_t words) {
+    if(words >= BITSET_KERNEL_MIN_WORDS) return setKernels.bitset_and_count(a, b, words);
+    size_t count = 0;
+    for(size_t i=0; i < words; ++i) count += __builtin_popcountll(a[i] & b[i]);
+    return count;
+}
+
+// TRUE if no bit is set
+inline bool bitset_empty(const uint64_t* a, size_t words) {
+    for(size_t i=0; i<words; ++i) {
+        if(a[i]) return false;
+    }
+    return true;
+}
+
+// TRUE if every bit of a is also set in b
+inline bool bitset_subset(const uint64_t* a, const uint64_t* b, size_t words) {
+    for(size_t i=0; i<words; ++i) {
+        if(a[i] & ~b[i]) return false;
+    }
+    return true;
+}
+
+// call function(i) for every set bit i in ascending order
+template <typename F> inline void bitset_foreach(const uint64_t* a, size_t words, F function) {
+    for(size_t i=0; i<words; ++i) {
+        for(uint64_t bits = a[i]; bits; bits &= bits - 1) {
+            function((int)(i * 64 + __builtin_ctzll(bits)));
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,249 @@
+#include "Canonical.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+CanonicalForm::CanonicalForm()
+    : leaves(0), n(0), hasLeaf(false)
+{
+}
+
+const std::vector<int>& CanonicalForm::labeling() const {
+    return this->bestLabeling;
+}
+
+std::string CanonicalForm::graph6(const Graph& G) {
+    this->adjacency_read(G);
+    this->leaves = 0;
+    this->hasLeaf = false;
+    this->automorphisms.clear();
+    this->path.clear();
+
+    Partition root;
+    this->partition_initial(root);
+    this->refine(root);
+    this->search(root, 0);
+
+    // graph6 of the best matrix: bits of the upper triangle column by column, 6 bits per character
+    std::string g6 = std::string(1, (char)(this->n + 63));
+    int bits = 0;
+    int value = 0;
+    for(int i=1; i<this->n; ++i) {
+        for(int j=0; j<i; ++j) {
+            value = (value << 1) | ((this->bestMatrix[i] >> j) & 1);
+            if(++bits == 6) {
+                g6.push_back((char)(value + 63));
+                bits = 0;
+                value = 0;
+            }
+        }
+    }
+    if(bits > 0) g6.push_back((char)((value << (6 - bits)) + 63));
+    return g6;
+}
+
+uint64_t CanonicalForm::invariant(const Graph& G) {
+    this->adjacency_read(G);
+    Partition partition;
+    this->partition_initial(partition);
+    this->refine(partition);
+
+    // the cells are equitable: number of neighbours of any vertex of cell i in cell j (quotient matrix)
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](uint64_t value) {
+        hash = (hash ^ value) * 1099511628211ull;
+    };
+    mix(this->n);
+    for(int i=0; i<partition.count; ++i) {
+        const int v = __builtin_ctz(partition.cells[i]);
+        mix(__builtin_popcount(partition.cells[i]));
+        for(int j=0; j<partition.count; ++j) mix(__builtin_popcount(this->adjacency[v] & partition.cells[j]));
+    }
+    return hash;
+}
+
+void CanonicalForm::adjacency_read(const Graph& G) {
+    if(G.n() > CANONICAL_MAX_N) {
+        throw std::runtime_error("canonical form only for graphs with at most " + std::to_string(CANONICAL_MAX_N) + " vertices, got n=" + std::to_string(G.n()));
+    }
+    this->n = G.n();
+    for(int v=0; v<this->n; ++v) {
+        this->adjacency[v] = 0;
+        for(int w=0; w<this->n; ++w) {
+            if(v != w && G.edge_has(v, w)) this->adjacency[v] |= 1 << w;
+        }
+    }
+}
+
+// cells of vertices with the same degree and number of triangles, ordered by degree then triangles
+void CanonicalForm::partition_initial(Partition& partition) const {
+    int keys[CANONICAL_MAX_N];
+    for(int v=0; v<this->n; ++v) {
+        int triangles = 0;
+        for(uint16_t rest = this->adjacency[v]; rest; rest &= rest - 1) {
+            triangles += __builtin_popcount(this->adjacency[__builtin_ctz(rest)] & this->adjacency[v]);
+        }
+        keys[v] = __builtin_popcount(this->adjacency[v]) * CANONICAL_MAX_N * CANONICAL_MAX_N + triangles / 2;
+    }
+
+    int sorted[CANONICAL_MAX_N];
+    std::copy(keys, keys + this->n, sorted);
+    std::sort(sorted, sorted + this->n);
+    partition.count = 0;
+    for(int i=0; i<this->n; ++i) {
+        if(i > 0 && sorted[i] == sorted[i-1]) continue;
+        uint16_t cell = 0;
+        for(int v=0; v<this->n; ++v) {
+            if(keys[v] == sorted[i]) cell |= 1 << v;
+        }
+        partition.cells[partition.count++] = cell;
+    }
+}
+
+// split the cells by the number of neighbours in every cell until nothing changes (1-dimensional Weisfeiler-Leman).
+// Sub-cells are ordered by the number of neighbours, so the result only depends on the graph and the ordered partition
+void CanonicalForm::refine(Partition& partition) const {
+    bool changed = true;
+    while(changed && partition.count < this->n) {
+        changed = false;
+        for(int w=0; w<partition.count && !changed; ++w) {
+            const uint16_t splitter = partition.cells[w];
+            Partition next;
+            next.count = 0;
+            for(int x=0; x<partition.count; ++x) {
+                const uint16_t cell = partition.cells[x];
+                if((cell & (cell - 1)) == 0) {
+                    next.cells[next.count++] = cell;
+                    continue;
+                }
+
+                uint16_t byCount[CANONICAL_MAX_N + 1] = {0};
+                for(uint16_t rest = cell; rest; rest &= rest - 1) {
+                    const int v = __builtin_ctz(rest);
+                    byCount[__builtin_popcount(this->adjacency[v] & splitter)] |= 1 << v;
+                }
+                int parts = 0;
+                for(int count=0; count<=this->n; ++count) {
+                    if(byCount[count] == 0) continue;
+                    next.cells[next.count++] = byCount[count];
+                    ++parts;
+                }
+                if(parts > 1) changed = true;
+            }
+            if(changed) partition = next;
+        }
+    }
+}
+
+int CanonicalForm::search(const Partition& partition, int depth) {
+    if(partition.count == this->n) return this->leaf(partition);
+
+    // individualize the vertices of the first non-singleton cell
+    int target = 0;
+    while((partition.cells[target] & (partition.cells[target] - 1)) == 0) ++target;
+    const uint16_t cell = partition.cells[target];
+
+    uint16_t searched = 0;
+    for(uint16_t rest = cell; rest; rest &= rest - 1) {
+        const int v = __builtin_ctz(rest);
+        // an automorphism fixing the path maps v to a searched vertex: same leaves
+        if(this->orbit(v, depth) & searched) continue;
+        searched |= 1 << v;
+
+        Partition child;
+        child.count = partition.count + 1;
+        std::copy(partition.cells, partition.cells + target, child.cells);
+        child.cells[target] = 1 << v;
+        child.cells[target + 1] = cell & ~(1 << v);
+        std::copy(partition.cells + target + 1, partition.cells + partition.count, child.cells + target + 2);
+        this->refine(child);
+
+        this->path.resize(depth);
+        this->path.push_back(v);
+        const int jump = this->search(child, depth + 1);
+        if(jump < depth) return jump;
+    }
+    return depth;
+}
+
+int CanonicalForm::leaf(const Partition& partition) {
+    ++this->leaves;
+    int position[CANONICAL_MAX_N];
+    this->labelingLeaf.resize(this->n);
+    for(int i=0; i<this->n; ++i) {
+        this->labelingLeaf[i] = __builtin_ctz(partition.cells[i]);
+        position[this->labelingLeaf[i]] = i;
+    }
+    uint16_t matrix[CANONICAL_MAX_N];
+    for(int i=0; i<this->n; ++i) {
+        matrix[i] = 0;
+        for(uint16_t rest = this->adjacency[this->labelingLeaf[i]]; rest; rest &= rest - 1) {
+            matrix[i] |= 1 << position[__builtin_ctz(rest)];
+        }
+    }
+
+    if(!this->hasLeaf) {
+        this->hasLeaf = true;
+        this->firstPath = this->path;
+        this->firstLabeling = this->labelingLeaf;
+        std::copy(matrix, matrix + this->n, this->firstMatrix);
+        this->bestPath = this->path;
+        this->bestLabeling = this->labelingLeaf;
+        std::copy(matrix, matrix + this->n, this->bestMatrix);
+        return this->n;
+    }
+
+    // same matrix as the first or best leaf: automorphism, the subtree below the common ancestor is an image of a searched one
+    const std::vector<int>* equalPath = nullptr;
+    const std::vector<int>* equalLabeling = nullptr;
+    if(std::equal(matrix, matrix + this->n, this->firstMatrix)) {
+        equalPath = &this->firstPath;
+        equalLabeling = &this->firstLabeling;
+    }
+    else if(std::equal(matrix, matrix + this->n, this->bestMatrix)) {
+        equalPath = &this->bestPath;
+        equalLabeling = &this->bestLabeling;
+    }
+    if(equalPath != nullptr) {
+        std::vector<int> to = std::vector<int>(this->n);
+        for(int i=0; i<this->n; ++i) to[this->labelingLeaf[i]] = (*equalLabeling)[i];
+        this->automorphism_add(to);
+
+        int common = 0;
+        while(common < (int)this->path.size() && common < (int)equalPath->size() && this->path[common] == (*equalPath)[common]) ++common;
+        return common;
+    }
+
+    if(std::lexicographical_compare(this->bestMatrix, this->bestMatrix + this->n, matrix, matrix + this->n)) {
+        this->bestPath = this->path;
+        this->bestLabeling = this->labelingLeaf;
+        std::copy(matrix, matrix + this->n, this->bestMatrix);
+    }
+    return this->n;
+}
+
+uint16_t CanonicalForm::orbit(int v, int depth) const {
+    uint16_t orbit = 1 << v;
+    bool changed = true;
+    while(changed) {
+        changed = false;
+        for(const auto& to : this->automorphisms) {
+            bool fixes = true;
+            for(int i=0; i<depth && fixes; ++i) fixes = to[this->path[i]] == this->path[i];
+            if(!fixes) continue;
+
+            for(uint16_t rest = orbit; rest; rest &= rest - 1) {
+                const uint16_t image = 1 << to[__builtin_ctz(rest)];
+                if(orbit & image) continue;
+                orbit |= image;
+                changed = true;
+            }
+        }
+    }
+    return orbit;
+}
+
+void CanonicalForm::automorphism_add(const std::vector<int>& to) {
+    if(this->automorphisms.size() < CANONICAL_MAX_AUTOMORPHISMS) this->automorphisms.push_back(to);
+}
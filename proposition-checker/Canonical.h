@@ -0,0 +1,76 @@
+#ifndef CANONICAL_H
+#define CANONICAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Graph.h"
+
+// largest graph that has a canonical form (one 16-bit row per vertex)
+#define CANONICAL_MAX_N 16
+// automorphisms kept for pruning per graph, later ones are not used (only less pruning)
+#define CANONICAL_MAX_AUTOMORPHISMS 64
+
+/** canonical labeling of small graphs (n <= CANONICAL_MAX_N) in the same process, instead of nauty-labelg.
+ * Individualization-refinement: the vertices are split by degree and triangle count, refined until every cell has the same
+ * number of neighbours in every cell (colour refinement), then one vertex of the first non-singleton cell is individualized
+ * and refined again until every vertex is in its own cell. The largest adjacency matrix of these leaves is the canonical form.
+ * Leaves with the same matrix give automorphisms, they prune children in the same orbit and subtrees that are images of
+ * subtrees that were already searched.
+ * The canonical graph6 is not the one of nauty-labelg, only strings of this class can be compared.
+ */
+class CanonicalForm {
+  public:
+    CanonicalForm();
+
+    // canonical graph6 of G: equal for two graphs if and only if they are isomorphic
+    std::string graph6(const Graph& G);
+    // vertex of G at position i of the canonical form of the last graph6()
+    const std::vector<int>& labeling() const;
+
+    // hash of the degree sequence, triangle counts and colour refinement: isomorphic graphs have the same hash
+    uint64_t invariant(const Graph& G);
+
+    // leaves of the search tree of the last graph6()
+    size_t leaves;
+
+  private:
+    int n;
+    uint16_t adjacency[CANONICAL_MAX_N];
+
+    // ordered partition: one bit mask per cell, one cell per level of the search tree
+    struct Partition {
+        uint16_t cells[CANONICAL_MAX_N];
+        int count;
+    };
+
+    // first leaf and best leaf: individualized vertices, labeling and permuted adjacency matrix
+    std::vector<int> firstPath;
+    std::vector<int> firstLabeling;
+    uint16_t firstMatrix[CANONICAL_MAX_N];
+    std::vector<int> bestPath;
+    std::vector<int> bestLabeling;
+    uint16_t bestMatrix[CANONICAL_MAX_N];
+    bool hasLeaf;
+    // scratch: labeling of the current leaf
+    std::vector<int> labelingLeaf;
+
+    // automorphisms found while searching (vertex -> image), at most CANONICAL_MAX_AUTOMORPHISMS
+    std::vector<std::vector<int>> automorphisms;
+    // individualized vertices of the current node
+    std::vector<int> path;
+
+    void adjacency_read(const Graph& G);
+    void partition_initial(Partition& partition) const;
+    void refine(Partition& partition) const;
+    // returns the depth to continue at (automorphisms let the search jump back)
+    int search(const Partition& partition, int depth);
+    int leaf(const Partition& partition);
+    // orbit of v under the automorphisms that fix the first `depth` vertices of the path
+    uint16_t orbit(int v, int depth) const;
+    void automorphism_add(const std::vector<int>& to);
+};
+
+#endif
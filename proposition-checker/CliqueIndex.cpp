@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <initializer_list>
+#include <utility>
+
+#include "CliqueIndex.h"
+
+#ifdef GRAPH_H_MATRIX_AND_LIST
+
+CliqueIndex::CliqueIndex(Graph* G)
+    : G(G), words(G->bits_words()), aliveCount(0), vertexCliques(G->n()), scratch(G->bits_words(), 0)
+{
+    for(auto& clique : G->getMaximalCliques().cliqueList) {
+        std::sort(clique.begin(), clique.end());
+        this->insert(std::move(clique));
+    }
+    // the initial cliques cannot be rolled back
+    this->changes.clear();
+}
+
+const std::vector<int>& CliqueIndex::clique(size_t id) const {
+    return this->cliques[id];
+}
+
+const std::vector<size_t>& CliqueIndex::vertex_cliques(int v) const {
+    return this->vertexCliques[v];
+}
+
+size_t CliqueIndex::size() const {
+    return this->aliveCount;
+}
+
+int CliqueIndex::vertexInMoreThanSCliques(size_t s) const {
+    for(size_t vid=0; vid<this->vertexCliques.size(); ++vid) {
+        if(this->vertexCliques[vid].size() > s) return vid;
+    }
+    return -1;
+}
+
+/** the cliques containing v and not w stop being maximal if all their other vertices are adjacent to w (same for w).
+ * The new maximal cliques all contain v and w: $\{v,w\} \cup C$ for every maximal clique C of $G[N(v) \cap N(w)]$
+ */
+void CliqueIndex::edge_added(int v, int w) {
+    const uint64_t* rowV = this->G->neighbors_row(v);
+    const uint64_t* rowW = this->G->neighbors_row(w);
+
+    // find first, removing changes the vertex lists
+    std::vector<size_t> extended = {};
+    for(const size_t id : this->vertexCliques[v]) {
+        if(bitset_subset(this->cliquesBits.data() + id * this->words, rowW, this->words)) extended.push_back(id);
+    }
+    for(const size_t id : this->vertexCliques[w]) {
+        if(bitset_subset(this->cliquesBits.data() + id * this->words, rowV, this->words)) extended.push_back(id);
+    }
+    for(const size_t id : extended) this->remove(id);
+
+    bitset_and(this->scratch.data(), rowV, rowW, this->words);
+    for(auto& clique : this->G->getMaximalCliquesInduced(this->scratch.data())) {
+        clique.push_back(v);
+        clique.push_back(w);
+        std::sort(clique.begin(), clique.end());
+        this->insert(std::move(clique));
+    }
+}
+
+/** the cliques containing v and w are not cliques anymore. The only new maximal cliques are
+ * $K \setminus \{v\}$ and $K \setminus \{w\}$ of these cliques K (if they are maximal)
+ */
+void CliqueIndex::edge_removed(int v, int w) {
+    std::vector<size_t> split = {};
+    for(const size_t id : this->vertexCliques[v]) {
+        if(bitset_test(this->cliquesBits.data() + id * this->words, w)) split.push_back(id);
+    }
+
+    const size_t firstNew = this->cliques.size();
+    for(const size_t id : split) {
+        this->remove(id);
+
+        for(const int vertex : {v, w}) {
+            std::vector<int> candidate = this->cliques[id];
+            candidate.erase(std::find(candidate.begin(), candidate.end(), vertex));
+            if(!this->isMaximal(candidate)) continue;
+
+            // two split cliques can leave the same clique
+            bool duplicate = false;
+            for(size_t other=firstNew; other<this->cliques.size() && !duplicate; ++other) {
+                duplicate = this->cliques[other] == candidate;
+            }
+            if(!duplicate) this->insert(std::move(candidate));
+        }
+    }
+}
+
+size_t CliqueIndex::checkpoint() const {
+    return this->changes.size();
+}
+
+void CliqueIndex::rollback(size_t checkpoint) {
+    while(this->changes.size() > checkpoint) {
+        const auto change = this->changes.back();
+        this->changes.pop_back();
+
+        // added cliques are undone in reverse order: always the last id
+        if(change.added) {
+            for(const int vid : this->cliques[change.id]) {
+                auto& list = this->vertexCliques[vid];
+                list.erase(std::lower_bound(list.begin(), list.end(), change.id));
+            }
+            this->cliques.pop_back();
+            this->cliquesBits.resize(this->cliquesBits.size() - this->words);
+            --this->aliveCount;
+        }
+        else {
+            for(const int vid : this->cliques[change.id]) {
+                auto& list = this->vertexCliques[vid];
+                list.insert(std::lower_bound(list.begin(), list.end(), change.id), change.id);
+            }
+            ++this->aliveCount;
+        }
+    }
+}
+
+void CliqueIndex::compact() {
+    if(this->cliques.size() > this->aliveCount) {
+        // the maximal cliques are exactly the cliques in the vertex lists
+        std::vector<bool> alive(this->cliques.size(), false);
+        for(const auto& list : this->vertexCliques) {
+            for(const size_t id : list) alive[id] = true;
+        }
+
+        auto cliquesOld = std::move(this->cliques);
+        this->cliques.clear();
+        this->cliquesBits.clear();
+        for(auto& list : this->vertexCliques) list.clear();
+        this->aliveCount = 0;
+        for(size_t id=0; id<cliquesOld.size(); ++id) {
+            if(alive[id]) this->insert(std::move(cliquesOld[id]));
+        }
+    }
+    this->changes.clear();
+}
+
+// add a maximal clique with the next id. The vertex lists stay sorted since the new id is the largest
+void CliqueIndex::insert(std::vector<int>&& clique) {
+    const size_t id = this->cliques.size();
+
+    this->cliquesBits.resize(this->cliquesBits.size() + this->words, 0);
+    uint64_t* bits = this->cliquesBits.data() + id * this->words;
+    for(const int vid : clique) {
+        bitset_set(bits, vid);
+        this->vertexCliques[vid].push_back(id);
+    }
+
+    this->cliques.push_back(std::move(clique));
+    ++this->aliveCount;
+    this->changes.push_back({.id = id, .added = true});
+}
+
+// mark a clique as not maximal anymore. Its vertices and bits are kept for the rollback
+void CliqueIndex::remove(size_t id) {
+    for(const int vid : this->cliques[id]) {
+        auto& list = this->vertexCliques[vid];
+        list.erase(std::lower_bound(list.begin(), list.end(), id));
+    }
+    --this->aliveCount;
+    this->changes.push_back({.id = id, .added = false});
+}
+
+bool CliqueIndex::isMaximal(const std::vector<int>& clique) {
+    // common neighbors of all clique vertices (a vertex is not its own neighbor, so these are outside the clique)
+    uint64_t* common = this->scratch.data();
+    std::fill(common, common + this->words, ~uint64_t(0));
+    for(const int vid : clique) {
+        bitset_and(common, common, this->G->neighbors_row(vid), this->words);
+        if(bitset_empty(common, this->words)) return true;
+    }
+    // the empty clique is only maximal in the empty graph
+    return clique.empty() && this->G->n() == 0;
+}
+
+CliqueCountCache::CliqueCountCache(Graph* G)
+    : G(G), entries(G->n(), {.count = 0, .cap = 0})
+{
+}
+
+size_t CliqueCountCache::count(int v, size_t cap) {
+    auto& entry = this->entries[v];
+
+    // counted with a large enough cap or the count is exact
+    if(entry.cap >= cap || entry.count < entry.cap) return std::min(entry.count, cap);
+
+    entry.count = this->G->countMaximalCliquesContaining(v, cap);
+    entry.cap = cap;
+    return entry.count;
+}
+
+int CliqueCountCache::vertexInMoreThanSCliques(size_t s) {
+    for(size_t vid=0; vid<this->entries.size(); ++vid) {
+        if(this->count(vid, s+1) > s) return vid;
+    }
+    return -1;
+}
+
+void CliqueCountCache::edge_changed(int v, int w) {
+    this->forget(v);
+    this->forget(w);
+
+    // common neighbors of v and w
+    const uint64_t* rowV = this->G->neighbors_row(v);
+    const uint64_t* rowW = this->G->neighbors_row(w);
+    for(size_t i=0; i<this->G->bits_words(); ++i) {
+        for(uint64_t bits = rowV[i] & rowW[i]; bits; bits &= bits - 1) {
+            this->forget(i * 64 + __builtin_ctzll(bits));
+        }
+    }
+}
+
+size_t CliqueCountCache::checkpoint() const {
+    return this->changes.size();
+}
+
+void CliqueCountCache::rollback(size_t checkpoint) {
+    while(this->changes.size() > checkpoint) {
+        const auto& change = this->changes.back();
+        this->entries[change.vid] = change.entry;
+        this->changes.pop_back();
+    }
+}
+
+void CliqueCountCache::forget(int v) {
+    // also log entries that were not counted yet: they could be counted before the rollback
+    auto& entry = this->entries[v];
+    this->changes.push_back({.vid = v, .entry = entry});
+    entry = {.count = 0, .cap = 0};
+}
+
+#endif
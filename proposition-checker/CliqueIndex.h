@@ -0,0 +1,120 @@
+#ifndef CLIQUE_INDEX_H
+#define CLIQUE_INDEX_H
+
+#include <cstddef>
+#include <vector>
+
+#include "Graph.h"
+
+class CliqueIndex;
+class CliqueCountCache;
+
+#ifdef GRAPH_H_MATRIX_AND_LIST
+
+/** all maximal cliques of a graph, kept up to date while single edges are added or removed.
+ * After G->edge_add(v,w) call edge_added(v,w), after G->edge_remove(v,w) call edge_removed(v,w).
+ * Only cliques that contain v or w are changed, new cliques are only searched in $N(v) \cap N(w)$.
+ * Every change is written to an undo log: rollback(checkpoint()) restores the cliques of an earlier graph.
+ */
+class CliqueIndex {
+  public:
+    explicit CliqueIndex(Graph* G);
+
+    // the maximal clique with this id (sorted vertex ids). Ids stay valid until they are rolled back
+    const std::vector<int>& clique(size_t id) const;
+    // ids of the maximal cliques containing vertex v
+    const std::vector<size_t>& vertex_cliques(int v) const;
+    // number of maximal cliques
+    size_t size() const;
+
+    // returns a vertex in more than s maximal cliques, otherwise -1
+    int vertexInMoreThanSCliques(size_t s) const;
+
+    // update after the edge vw was added to the graph
+    void edge_added(int v, int w);
+    // update after the edge vw was removed from the graph
+    void edge_removed(int v, int w);
+
+    // position in the undo log
+    size_t checkpoint() const;
+    // undo all changes after the checkpoint (the graph has to be the same as at the checkpoint)
+    void rollback(size_t checkpoint);
+    // drop the undo log and the cliques that are not maximal anymore. Renumbers the clique ids, earlier checkpoints become invalid
+    void compact();
+
+  private:
+    Graph* G;
+    size_t words;
+
+    // clique id -> sorted vertex ids
+    std::vector<std::vector<int>> cliques;
+    // clique id -> bitset of the vertices (`words` words per clique)
+    BitsetVector cliquesBits;
+    // number of cliques that are currently maximal (removed cliques keep their id for the rollback)
+    size_t aliveCount;
+
+    // vertex id -> ids of the maximal cliques containing the vertex
+    std::vector<std::vector<size_t>> vertexCliques;
+
+    // undo log: clique id + TRUE if the clique was added, FALSE if removed
+    struct Change {
+        size_t id;
+        bool added;
+    };
+    std::vector<Change> changes;
+
+    // scratch bitset of `words` words
+    BitsetVector scratch;
+
+    void insert(std::vector<int>&& clique);
+    void remove(size_t id);
+    // TRUE if no vertex outside the clique is adjacent to all its vertices
+    bool isMaximal(const std::vector<int>& clique);
+};
+
+/** per vertex: the number of maximal cliques containing the vertex (counted in its neighborhood, up to a cap).
+ * An edit of vw only changes $G[N(x)]$ for x = v, x = w and the common neighbors x of v and w,
+ * so edge_changed(v,w) only forgets the counts of these vertices.
+ * Like CliqueIndex: rollback(checkpoint()) restores the forgotten counts after the edits were undone.
+ */
+class CliqueCountCache {
+  public:
+    explicit CliqueCountCache(Graph* G);
+
+    // number of maximal cliques containing v, at most cap
+    size_t count(int v, size_t cap);
+
+    // returns the first vertex in more than s maximal cliques, otherwise -1
+    int vertexInMoreThanSCliques(size_t s);
+
+    // update after the edge vw was added to or removed from the graph
+    void edge_changed(int v, int w);
+
+    // position in the undo log
+    size_t checkpoint() const;
+    // restore the counts forgotten after the checkpoint (the graph has to be the same as at the checkpoint)
+    void rollback(size_t checkpoint);
+
+  private:
+    Graph* G;
+
+    // vertex id -> counted cliques and the cap used for counting: exact if count < cap. cap=0 if not counted yet
+    struct Entry {
+        size_t count;
+        size_t cap;
+    };
+    std::vector<Entry> entries;
+
+    // undo log: vertex id + entry before it was forgotten
+    struct Change {
+        int vid;
+        Entry entry;
+    };
+    std::vector<Change> changes;
+
+    void forget(int v);
+};
+
+#endif
+
+#endif
@@ -0,0 +1,157 @@
+#include "ExternalUnique.h"
+
+#include <algorithm>
+#include <queue>
+#include <stdexcept>
+#include <unistd.h>
+#include <cstdlib>
+
+ExternalUnique::ExternalUnique(size_t memoryBytes, const std::string& directory, bool firstSeenOrder)
+    : runsWritten(0), memoryBytes(memoryBytes), directory(directory), firstSeenOrder(firstSeenOrder), records(), recordsBytes(0), sequence(0), runs()
+{
+}
+
+ExternalUnique::~ExternalUnique() {
+    for(FILE* run : this->runs) fclose(run);
+}
+
+void ExternalUnique::add(std::string_view line) {
+    this->records.push_back({.key = std::string(line), .sequence = this->sequence++});
+    this->recordsBytes += ExternalUnique::record_bytes(this->records.back());
+    if(this->recordsBytes >= this->memoryBytes) this->run_write(false);
+}
+
+void ExternalUnique::finish(const std::function<void(const std::string&)>& print) {
+    // first occurrence of every key, sorted by key
+    std::vector<Record> unique = std::vector<Record>();
+    auto uniqueEmit = [this, &print, &unique](const Record& record) {
+        if(!this->firstSeenOrder) {
+            print(record.key);
+            return;
+        }
+        unique.push_back(record);
+        this->recordsBytes += ExternalUnique::record_bytes(record);
+        if(this->recordsBytes >= this->memoryBytes) {
+            std::swap(unique, this->records);
+            this->run_write(true);
+            unique.clear();
+        }
+    };
+
+    if(this->runs.empty()) {
+        std::sort(this->records.begin(), this->records.end(), [](const Record& a, const Record& b) {
+            return a.key < b.key || (a.key == b.key && a.sequence < b.sequence);
+        });
+        std::vector<Record> sorted = std::vector<Record>();
+        std::swap(sorted, this->records);
+        this->recordsBytes = 0;
+        for(size_t i=0; i<sorted.size(); ++i) {
+            if(i == 0 || sorted[i].key != sorted[i-1].key) uniqueEmit(sorted[i]);
+        }
+    }
+    else {
+        if(!this->records.empty()) this->run_write(false);
+        // equal keys come out by run, the runs are in input order: the first one has the smallest sequence
+        bool hasPrevious = false;
+        std::string previous = "";
+        this->runs_merge(false, [&hasPrevious, &previous, &uniqueEmit](const Record& record) {
+            if(hasPrevious && record.key == previous) return;
+            hasPrevious = true;
+            previous = record.key;
+            uniqueEmit(record);
+        });
+    }
+    if(!this->firstSeenOrder) return;
+
+    // unique keys in the order of the input
+    if(this->runs.empty()) {
+        std::sort(unique.begin(), unique.end(), [](const Record& a, const Record& b) {
+            return a.sequence < b.sequence;
+        });
+        for(const auto& record : unique) print(record.key);
+        return;
+    }
+    std::swap(unique, this->records);
+    if(!this->records.empty()) this->run_write(true);
+    this->runs_merge(true, [&print](const Record& record) {
+        print(record.key);
+    });
+}
+
+void ExternalUnique::run_write(bool bySequence) {
+    if(bySequence) {
+        std::sort(this->records.begin(), this->records.end(), [](const Record& a, const Record& b) {
+            return a.sequence < b.sequence;
+        });
+    }
+    else {
+        std::sort(this->records.begin(), this->records.end(), [](const Record& a, const Record& b) {
+            return a.key < b.key || (a.key == b.key && a.sequence < b.sequence);
+        });
+    }
+
+    std::string path = this->directory + "/uniqueStringsXXXXXX";
+    const int fd = mkstemp(path.data());
+    FILE* run = fd >= 0 ? fdopen(fd, "w+b") : nullptr;
+    if(run == nullptr) throw std::runtime_error("could not create a temporary file in " + this->directory);
+    // deleted when it is closed
+    unlink(path.c_str());
+
+    for(size_t i=0; i<this->records.size(); ++i) {
+        const Record& record = this->records[i];
+        // duplicates in the run: only the first one
+        if(!bySequence && i > 0 && record.key == this->records[i-1].key) continue;
+
+        const uint32_t length = record.key.size();
+        if(fwrite(&length, sizeof(length), 1, run) != 1 || fwrite(record.key.data(), 1, length, run) != length
+            || fwrite(&record.sequence, sizeof(record.sequence), 1, run) != 1) {
+            throw std::runtime_error("could not write a temporary file in " + this->directory);
+        }
+    }
+    rewind(run);
+    this->runs.push_back(run);
+    ++this->runsWritten;
+
+    this->records.clear();
+    this->recordsBytes = 0;
+}
+
+void ExternalUnique::runs_merge(bool bySequence, const std::function<void(const Record&)>& emit) {
+    std::vector<FILE*> merged = std::vector<FILE*>();
+    std::swap(merged, this->runs);
+
+    // the smallest record of every run. Ties by run: earlier runs have the earlier lines
+    std::vector<Record> heads = std::vector<Record>(merged.size());
+    auto greater = [&heads, bySequence](size_t a, size_t b) {
+        if(bySequence) return heads[a].sequence > heads[b].sequence;
+        if(heads[a].key != heads[b].key) return heads[a].key > heads[b].key;
+        return a > b;
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(greater)> queue(greater);
+    for(size_t run=0; run<merged.size(); ++run) {
+        if(ExternalUnique::record_read(merged[run], heads[run])) queue.push(run);
+    }
+
+    while(!queue.empty()) {
+        const size_t run = queue.top();
+        queue.pop();
+        emit(heads[run]);
+        if(ExternalUnique::record_read(merged[run], heads[run])) queue.push(run);
+    }
+    for(FILE* run : merged) fclose(run);
+}
+
+bool ExternalUnique::record_read(FILE* file, Record& record) {
+    uint32_t length = 0;
+    if(fread(&length, sizeof(length), 1, file) != 1) return false;
+    record.key.resize(length);
+    if(fread(record.key.data(), 1, length, file) != length || fread(&record.sequence, sizeof(record.sequence), 1, file) != 1) {
+        throw std::runtime_error("temporary file of uniqueStrings is truncated");
+    }
+    return true;
+}
+
+// memory of a record in the vector (string header and characters)
+size_t ExternalUnique::record_bytes(const Record& record) {
+    return sizeof(Record) + record.key.capacity();
+}
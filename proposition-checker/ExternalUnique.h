@@ -0,0 +1,56 @@
+#ifndef EXTERNAL_UNIQUE_H
+#define EXTERNAL_UNIQUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/** unique strings of a stream that does not fit into memory (uniqueStrings -b).
+ * The strings are kept in memory until memoryBytes is reached, then they are sorted, duplicates are removed and the run is
+ * written to a temporary file. finish() merges all runs (k-way) and calls print once per unique string in sorted order.
+ * With firstSeenOrder every string keeps the sequence number of its first line: the unique strings are sorted again by it
+ * (also in runs on disk), so the output is in the order of the input like without a memory budget.
+ * Temporary files are deleted when they are closed.
+ */
+class ExternalUnique {
+  public:
+    ExternalUnique(size_t memoryBytes, const std::string& directory="/tmp", bool firstSeenOrder=false);
+    ~ExternalUnique();
+    ExternalUnique(const ExternalUnique&) = delete;
+    ExternalUnique& operator=(const ExternalUnique&) = delete;
+
+    void add(std::string_view line);
+    // print every unique string once. Only call once after the last add()
+    void finish(const std::function<void(const std::string&)>& print);
+
+    // runs written to disk
+    size_t runsWritten;
+
+  private:
+    struct Record {
+        std::string key;
+        uint64_t sequence;
+    };
+
+    size_t memoryBytes;
+    std::string directory;
+    bool firstSeenOrder;
+
+    std::vector<Record> records;
+    size_t recordsBytes;
+    uint64_t sequence;
+    std::vector<FILE*> runs;
+
+    // sort the records (by key or sequence), write them to a new run and clear them
+    void run_write(bool bySequence);
+    // merge the runs (sorted by key or sequence) and close them, call emit per record in order
+    void runs_merge(bool bySequence, const std::function<void(const Record&)>& emit);
+    static bool record_read(FILE* file, Record& record);
+    static size_t record_bytes(const Record& record);
+};
+
+#endif
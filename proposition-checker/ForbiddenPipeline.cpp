@@ -0,0 +1,162 @@
+#include "ForbiddenPipeline.h"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+
+#include "Graph.h"
+#include "GraphBinary.h"
+#include "Canonical.h"
+#include "StringSet.h"
+#include "Queue.h"
+
+// batches in a ring
+#define FORBIDDEN_PIPELINE_RING_BATCHES 8
+
+ForbiddenPipeline::ForbiddenPipeline(size_t s, unsigned int threads, size_t batchGraphs)
+    : s(s), threadCount(threads > 0 ? threads : std::max(1, (int)std::thread::hardware_concurrency() - 2)),
+      batchGraphs(std::max(batchGraphs, (size_t)1)), graphsCount(0), prefilterCount(0), forbiddenCount(0), uniqueCount(0)
+{
+}
+
+size_t ForbiddenPipeline::graphs() const {
+    return this->graphsCount;
+}
+
+size_t ForbiddenPipeline::prefilterDecided() const {
+    return this->prefilterCount;
+}
+
+size_t ForbiddenPipeline::forbiddenFound() const {
+    return this->forbiddenCount;
+}
+
+size_t ForbiddenPipeline::size() const {
+    return this->uniqueCount;
+}
+
+unsigned int ForbiddenPipeline::threads() const {
+    return this->threadCount;
+}
+
+void ForbiddenPipeline::run(std::istream& input, const std::function<void(const std::string&)>& print) {
+    this->runStages([&input](const GraphAppend& append) {
+        Graph G = Graph(0);
+        std::vector<uint8_t> bits = {};
+        std::string line;
+        while(std::getline(input, line)) {
+            if(line.empty()) continue;
+            G.assign_graph6(line);
+            bits.resize(Graph::triangle_bytes(G.n()));
+            G.triangle_bits(bits.data());
+            append(G.n(), bits.data());
+        }
+    }, print);
+}
+
+void ForbiddenPipeline::run(const GraphCorpus& corpus, const std::function<void(const std::string&)>& print) {
+    this->runStages([&corpus](const GraphAppend& append) {
+        for(size_t record=0; record<corpus.size(); ++record) append(corpus.header().n, corpus.triangle(record));
+    }, print);
+}
+
+// findMinimalForbidden (like minimalForbiddenGenerate without -x) for every graph of the batches.
+// An exception is kept in error, the following batches are only passed on (empty) so the other stages do not wait forever
+void ForbiddenPipeline::work(SpscRing<GraphBatch>& input, SpscRing<ForbiddenBatch>& output, size_t s, std::exception_ptr& error) {
+    OverlappingEditingOptions options = {
+        .useFellowsForbidden = false,
+        .useForbiddenCliques = true,
+    };
+    std::vector<CliqueType> cliquesOverlappingU = {};
+    std::vector<int> forbiddenVertices = {};
+    CanonicalForm canonical = CanonicalForm();
+    Graph G = Graph(0);
+
+    GraphBatch batch;
+    while(input.pop(batch)) {
+        ForbiddenBatch found;
+        const size_t triangleBytes = Graph::triangle_bytes(batch.n);
+        try {
+            for(size_t i=0; i<batch.count && !error; ++i) {
+                G.assign_triangle_bits(batch.n, batch.bits.data() + i * triangleBytes);
+                ++found.graphs;
+
+                bool prefilterDecided = false;
+                const bool foundForbidden = findMinimalForbidden(&G, s, options, cliquesOverlappingU, forbiddenVertices, prefilterDecided);
+                if(prefilterDecided) ++found.prefilterDecided;
+                if(!foundForbidden) continue;
+
+                found.forbidden.push_back(canonical.graph6(G.getSubgraph(forbiddenVertices)));
+            }
+        }
+        catch(...) {
+            error = std::current_exception();
+        }
+        output.push(std::move(found));
+    }
+    output.close();
+}
+
+void ForbiddenPipeline::runStages(const std::function<void(const GraphAppend& append)>& read, const std::function<void(const std::string&)>& print) {
+    const unsigned int threads = this->threadCount;
+    std::vector<std::unique_ptr<SpscRing<GraphBatch>>> inputs = {};
+    std::vector<std::unique_ptr<SpscRing<ForbiddenBatch>>> outputs = {};
+    for(unsigned int thread=0; thread<threads; ++thread) {
+        inputs.push_back(std::make_unique<SpscRing<GraphBatch>>(FORBIDDEN_PIPELINE_RING_BATCHES));
+        outputs.push_back(std::make_unique<SpscRing<ForbiddenBatch>>(FORBIDDEN_PIPELINE_RING_BATCHES));
+    }
+    std::vector<std::exception_ptr> errors = std::vector<std::exception_ptr>(threads);
+    std::vector<std::thread> workers = {};
+    for(unsigned int thread=0; thread<threads; ++thread) {
+        workers.emplace_back(ForbiddenPipeline::work, std::ref(*inputs[thread]), std::ref(*outputs[thread]), this->s, std::ref(errors[thread]));
+    }
+
+    // reader: batch b to worker b % threads. The rings are closed also after an exception (bad line or corpus)
+    std::exception_ptr readerError = nullptr;
+    const size_t batchGraphs = this->batchGraphs;
+    std::thread reader = std::thread([&inputs, &read, &readerError, threads, batchGraphs]() {
+        GraphBatch batch;
+        size_t batchNumber = 0;
+        auto flush = [&]() {
+            if(batch.count == 0) return;
+            inputs[batchNumber++ % threads]->push(std::move(batch));
+            batch = GraphBatch();
+        };
+        try {
+            read([&](unsigned int n, const uint8_t* bits) {
+                if(batch.count > 0 && batch.n != n) flush();
+                batch.n = n;
+                batch.bits.insert(batch.bits.end(), bits, bits + Graph::triangle_bytes(n));
+                if(++batch.count == batchGraphs) flush();
+            });
+            flush();
+        }
+        catch(...) {
+            readerError = std::current_exception();
+        }
+        for(auto& ring : inputs) ring->close();
+    });
+
+    // output: batches in the order of the reader
+    StringSet printed = StringSet(1 << 12);
+    this->graphsCount = 0;
+    this->prefilterCount = 0;
+    this->forbiddenCount = 0;
+    ForbiddenBatch found;
+    for(size_t batchNumber=0; outputs[batchNumber % threads]->pop(found); ++batchNumber) {
+        this->graphsCount += found.graphs;
+        this->prefilterCount += found.prefilterDecided;
+        this->forbiddenCount += found.forbidden.size();
+        for(const auto& graph6 : found.forbidden) {
+            if(printed.insert(graph6)) print(graph6);
+        }
+    }
+    this->uniqueCount = printed.size();
+
+    reader.join();
+    for(auto& thread : workers) thread.join();
+    if(readerError) std::rethrow_exception(readerError);
+    for(const auto& error : errors) {
+        if(error) std::rethrow_exception(error);
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef FORBIDDEN_PIPELINE_H
+#define FORBIDDEN_PIPELINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <istream>
+#include <string>
+#include <vector>
+
+class GraphCorpus;
+template <typename T>
+class SpscRing;
+
+/** minimal forbidden subgraphs, their canonical form and unique in one process (minimalForbiddenPipeline).
+ * Stages, connected by lock-free rings (SpscRing) of batches:
+ * - reader thread: graph6 lines or records of a corpus -> packed adjacency bits (Graph::triangle_bits)
+ * - worker threads: forbidden subgraph around a vertex in more than s cliques like minimalForbiddenGenerate -> canonical graph6
+ * - output (calling thread): StringSet of the canonical graph6, prints every forbidden subgraph once
+ * Batch b goes to worker b % threads and the output takes the batches in the same order,
+ * so the output is the same as minimalForbiddenGenerate -u for any number of threads.
+ */
+class ForbiddenPipeline {
+  public:
+    // threads = 0: one worker per hardware thread minus the reader and the output thread (at least one)
+    ForbiddenPipeline(size_t s, unsigned int threads, size_t batchGraphs=1024);
+
+    // read all graph6 lines of input (or all records of corpus) and call print (on the calling thread) once per forbidden subgraph.
+    // An exception of the reader or a worker is thrown after all threads finished
+    void run(std::istream& input, const std::function<void(const std::string&)>& print);
+    void run(const GraphCorpus& corpus, const std::function<void(const std::string&)>& print);
+
+    // after run(): graphs read, graphs decided by the prefilter, forbidden subgraphs found (with duplicates) and printed
+    size_t graphs() const;
+    size_t prefilterDecided() const;
+    size_t forbiddenFound() const;
+    size_t size() const;
+    unsigned int threads() const;
+
+  private:
+    // graphs with the same number of vertices as packed adjacency bits
+    struct GraphBatch {
+        unsigned int n = 0;
+        size_t count = 0;
+        std::vector<uint8_t> bits;
+    };
+
+    // canonical graph6 of the forbidden subgraphs of one batch of graphs
+    struct ForbiddenBatch {
+        size_t graphs = 0;
+        size_t prefilterDecided = 0;
+        std::vector<std::string> forbidden;
+    };
+
+    // read calls append once per graph
+    using GraphAppend = std::function<void(unsigned int n, const uint8_t* bits)>;
+    void runStages(const std::function<void(const GraphAppend& append)>& read, const std::function<void(const std::string&)>& print);
+    static void work(SpscRing<GraphBatch>& input, SpscRing<ForbiddenBatch>& output, size_t s, std::exception_ptr& error);
+
+    size_t s;
+    unsigned int threadCount;
+    size_t batchGraphs;
+    size_t graphsCount;
+    size_t prefilterCount;
+    size_t forbiddenCount;
+    size_t uniqueCount;
+};
+
+#endif
@@ -2,6 +2,8 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <array>
+#include <deque>
 #include <chrono>
 #include <unordered_set>
 
@@ -10,8 +12,13 @@
 #include <stdexcept>
 #include <iostream>
 #include <functional>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 #include "Graph.h"
+#include "CliqueIndex.h"
 
 #ifndef DEBUG
 // use DEBUG if you want to debug
@@ -53,6 +60,8 @@ std::string OverlappingEditingOptionsToString(const OverlappingEditingOptions& o
         + "forbiddenCopy=" + std::to_string(options.forbiddenCopy) + ", "
 
         + "forbiddenMaxCount=" + std::to_string(options.forbiddenMaxCount) + ", "
+        + "incrementalCliques=" + std::to_string(options.incrementalCliques) + ", "
+        + "localCliqueCounts=" + std::to_string(options.localCliqueCounts) + ", "
 
         + "\n\ttimeTotal=" + std::to_string(options.timeTotal) + "µs, "
         + "timeFindingCliques=" + std::to_string(options.timeFindingCliques) + "µs, "
@@ -70,91 +79,88 @@ std::string OverlappingEditingOptionsToString(const OverlappingEditingOptions& o
     +"}";
 }
 
-/** calculate a degeneracy + degeneracy ordering of the graph O(4 * n * \Delta). If s>0, then the bound is also returned
+/** calculate a degeneracy + degeneracy ordering of the graph in O(n + m) with a bucket queue on flat arrays. If s>0, then the bound is also returned
  * [Eppstein et al. 2010 - Listing All Maximal Cliques in Sparse Graphs in Near-optimal Time, Section 2.1 before Lemma 1]
+ * [Matula, Beck 1983 - Smallest-last ordering and clustering and graph coloring algorithms]
+ * [Batagelj, Zaversnik 2003 - An O(m) Algorithm for Cores Decomposition of Networks]
+ * The ordering is written into result.ordering: a reused result does not allocate again.
  */
-DegeneracyAndOrdering Graph::getDegeneracyOrdering(int s, int k) const {
+void Graph::getDegeneracyOrdering(DegeneracyAndOrdering& result, int s, int k) const {
     int n = this->n();
 
-    // Track smallest degree
-    int smallestDegree = n;
-
-    // vertexId -> current degree O(n)
-    std::vector<int> verticesMap = std::vector<int>(n);
-
-    // degree -> list of vertex pointers O(n)
-    std::vector<std::unordered_set<int>> degreesMap = std::vector<std::unordered_set<int>>(n, std::unordered_set<int>(n));
-
-    // build initial maps in O(n)
+    // scratch arrays, reused between calls so the branch and bound does not allocate them at every node
+    // vertexId -> current degree
+    thread_local std::vector<int> degrees;
+    // vertexId -> position in ordering
+    thread_local std::vector<int> positions;
+    // degree -> position of the first vertex with that degree in ordering
+    thread_local std::vector<int> degreeStarts;
+    degrees.resize(n);
+    positions.resize(n);
+    degreeStarts.assign(n + 1, 0);
+
+    // the vertices sorted by their current degree. Positions [0, i) are removed and are the degeneracy ordering
+    std::vector<int>& ordering = result.ordering;
+    ordering.resize(n);
+
+    // counting sort of the vertices by degree O(n)
     for(int vid=0; vid<n; ++vid) {
-        int degree = this->degree(vid);
-        verticesMap[vid] = degree;
-
-        smallestDegree = std::min(smallestDegree, degree);
-
-        degreesMap[degree].insert(vid);
+#ifdef GRAPH_H_MATRIX_AND_LIST
+        degrees[vid] = bitset_count(this->neighbors_row(vid), this->bits_words());
+#else
+        degrees[vid] = this->degree(vid);
+#endif
+        ++degreeStarts[degrees[vid]];
+    }
+    for(int d=0, start=0; d<=n; ++d) {
+        const int count = degreeStarts[d];
+        degreeStarts[d] = start;
+        start += count;
+    }
+    for(int vid=0; vid<n; ++vid) {
+        positions[vid] = degreeStarts[degrees[vid]]++;
+        ordering[positions[vid]] = vid;
+    }
+    for(int d=n; d>0; --d) {
+        degreeStarts[d] = degreeStarts[d-1];
     }
+    degreeStarts[0] = 0;
 
-    std::vector<int> degeneracyOrdering;
     int degeneracy = 0;
     int editBound = 0;
 
-    // do the ordering O(n * \Delta)
+    // remove the vertex with the smallest degree O(n + m): the unremoved vertices stay sorted by degree
     for(int i=0; i<n; ++i) {
-        auto& listSmallest = degreesMap[smallestDegree];
-
-        // get a vertex with the smallest degree
-        /*int vid = listSmallest.back();
-        listSmallest.pop_back();*/
-        int vid = *listSmallest.begin();
-        listSmallest.erase(vid);
-
-        // removed last entry in the list - find next smallestDegree
-        if(listSmallest.empty() && i<n-1) {
-            // find next smallest degree O(\Delta)
-            bool found = false;
-            for(int d=smallestDegree; d<n; ++d) {
-                if(!degreesMap.at(d).empty()) {
-                    smallestDegree = d;
-                    found = true;
-                    break;
-                }
-            }
-            if(!found) {
-                std::cout << __FILE__ <<":"<<__LINE__
-                    <<" no other smallest degree found for i=" << i << ", smallestDegree= " << smallestDegree << "\n";
-                break;
-            }
-        }
-
-        // "remove" from the graph
-        verticesMap.at(vid) = -1;
-
-        // decrease degree of neighbors O(\Delta)
-        int degreeHere = 0;
-        for(int neighborId : this->neighbors(vid)) {
-            int degreePrevious = verticesMap.at(neighborId);
-            if(degreePrevious < 0) continue;
-
-            int degreeNew = degreePrevious - 1;
-            ++degreeHere;
-
-            // update neighbor degree
-            verticesMap.at(neighborId) = degreeNew;
-
-            // remove from old degree list O(1)
-            degreesMap.at(degreePrevious).erase(neighborId);
-
-            // add to new degree list O(1)
-            degreesMap.at(degreeNew).insert(neighborId);
-
-            // update smallest degree
-            if(degreeNew < smallestDegree) {
-                smallestDegree = degreeNew;
-            }
-        }
+        const int vid = ordering[i];
+        // number of neighbors not yet removed
+        const int degreeHere = degrees[vid];
+
+        // "remove" from the graph: pop from its degree bucket. A neighbor can now drop to degreeHere-1, that bucket starts after vid
+        degreeStarts[degreeHere] = i + 1;
+        if(degreeHere > 0) degreeStarts[degreeHere - 1] = i + 1;
+
+        // decrease degree of neighbors O(\Delta): swap the neighbor to the front of its bucket and move the bucket start behind it
+        const auto decrease = [&](int neighborId) {
+            if(positions[neighborId] <= i) return;
+
+            const int degreePrevious = degrees[neighborId];
+            const int positionFirst = degreeStarts[degreePrevious];
+            const int vertexFirst = ordering[positionFirst];
+
+            ordering[positions[neighborId]] = vertexFirst;
+            positions[vertexFirst] = positions[neighborId];
+            ordering[positionFirst] = neighborId;
+            positions[neighborId] = positionFirst;
+
+            ++degreeStarts[degreePrevious];
+            --degrees[neighborId];
+        };
+#ifdef GRAPH_H_MATRIX_AND_LIST
+        bitset_foreach(this->neighbors_row(vid), this->bits_words(), decrease);
+#else
+        for(int neighborId : this->neighbors(vid)) decrease(neighborId);
+#endif
 
-        degeneracyOrdering.push_back(vid);
         degeneracy = std::max(degeneracy, degreeHere);
 
         // find a minimum number of edits using the conjecture that stars are bad for all s and that you need $|leaves| - s$ edits
@@ -173,45 +179,134 @@ DegeneracyAndOrdering Graph::getDegeneracyOrdering(int s, int k) const {
         }
     }
 
-    return {degeneracy: degeneracy, ordering: degeneracyOrdering, editBound: editBound};
+    result.degeneracy = degeneracy;
+    result.editBound = editBound;
 }
 
-/** Bron-Kerbosch with Pivot.
+/** degeneracy ordering of G for one Bron-Kerbosch call, kept per thread so the generators do not allocate one for every graph.
+ * A callback can enumerate maximal cliques again on the same thread: every nesting level has its own ordering.
+ */
+class DegeneracyOrderingScratch {
+  public:
+    DegeneracyOrderingScratch(const Graph* G, int s=0, int k=0) {
+        if(depth == levels.size()) levels.emplace_back();
+        this->info = &levels[depth++];
+        G->getDegeneracyOrdering(*this->info, s, k);
+    }
+    ~DegeneracyOrderingScratch() {
+        --depth;
+    }
+    DegeneracyOrderingScratch(const DegeneracyOrderingScratch&) = delete;
+    DegeneracyOrderingScratch& operator=(const DegeneracyOrderingScratch&) = delete;
+
+    const DegeneracyAndOrdering& operator*() const {
+        return *this->info;
+    }
+
+  private:
+    // std::deque: the orderings of the outer levels stay in place when a level is added
+    static thread_local std::deque<DegeneracyAndOrdering> levels;
+    static thread_local size_t depth;
+    DegeneracyAndOrdering* info;
+};
+thread_local std::deque<DegeneracyAndOrdering> DegeneracyOrderingScratch::levels;
+thread_local size_t DegeneracyOrderingScratch::depth = 0;
+
+// state shared by the threads of BronKerboschDegeneracyParallel
+struct MaximalCliquesShared {
+    // vertex id -> number of maximal cliques found by all threads (only counted if s>0)
+    std::vector<std::atomic<unsigned int>> vertexCliqueCounts;
+    // first vertex found in more than s cliques by any thread, otherwise -1. Stops all threads if stopAfterOneVertexInMoreThanS=TRUE
+    std::atomic<int> vertexInMoreThanSCliques;
+};
+
+/** report R as a maximal clique and count the number of cliques per vertex.
  * Returns -1 if there was no vertex found in more than `s` cliques, otherwise the vertex id (if s=0 then always returns -1).
- * [Eppstein et al. 2010 - Listing All Maximal Cliques in Sparse Graphs in Near-optimal Time, Figure 2: BronKerboschPivot]
+ * If the callback returns FALSE, result.callbackStopped is set (and -1 returned): the callers stop the enumeration.
  */
-int BronKerboschPivot(Graph* G, MaximalCliquesInfo& result, size_t s, bool stopAfterOneVertexInMoreThanS
+int BronKerboschReport(MaximalCliquesInfo& result, size_t s, bool stopAfterOneVertexInMoreThanS,
 #ifndef GRAPH_H_MATRIX_AND_LIST
-    , std::unordered_set<int>& P, std::unordered_set<int>& R, std::unordered_set<int>& X
+    const std::unordered_set<int>& R
 #else
-    , std::vector<int>& P, std::vector<int>& R, std::vector<int>& X
+    const std::vector<int>& R
 #endif
 ) {
-    // if $P \cup X = \emptyset$
-    if(P.empty() && X.empty()) {
-        // report R as a maximal clique
+    // report R as a maximal clique
+    if(result.pool != nullptr) result.pool->push(R);
 #ifndef GRAPH_H_MATRIX_AND_LIST
-        if(result.cliqueListEnabled) result.cliqueList.push_back(std::unordered_set<int>(R));
+    else if(result.cliqueListEnabled) result.cliqueList.push_back(std::unordered_set<int>(R));
 #else
-        if(result.cliqueListEnabled) result.cliqueList.push_back(std::vector<int>(R));
+    else if(result.cliqueListEnabled) result.cliqueList.push_back(std::vector<int>(R));
 #endif
 
-        // count number of cliques per vertex, if >s then return that vertex id
-        if(s > 0) {
-            // already found one
-            if(stopAfterOneVertexInMoreThanS && result.vertexInMoreThanSCliques != -1) return result.vertexInMoreThanSCliques;
+    const size_t cliqueIndex = result.cliqueCount++;
 
-            // count
+    // the consumer has what it needs: the recursion checks callbackStopped and returns
+    if(result.callback != nullptr && !(*result.callback)(R)) {
+        result.callbackStopped = true;
+        return -1;
+    }
+
+    // count number of cliques per vertex, if >s then return that vertex id
+    if(s > 0) {
+        // already found one
+        if(stopAfterOneVertexInMoreThanS && result.vertexInMoreThanSCliques != -1) return result.vertexInMoreThanSCliques;
+
+        // several threads: count in the shared counts, another thread may have found a vertex already
+        if(result.shared != nullptr) {
+            if(stopAfterOneVertexInMoreThanS) {
+                const int found = result.shared->vertexInMoreThanSCliques.load(std::memory_order_relaxed);
+                if(found >= 0) return found;
+            }
             for(auto vid : R) {
-                auto& list = result.vertexCliques.at(vid);
-                list.push_back(result.cliqueList.size() - 1);
-                if(list.size() > s) {
+                if(result.shared->vertexCliqueCounts[vid].fetch_add(1, std::memory_order_relaxed) + 1 > s) {
+                    int expected = -1;
+                    result.shared->vertexInMoreThanSCliques.compare_exchange_strong(expected, vid);
                     result.vertexInMoreThanSCliques = vid;
                     if(stopAfterOneVertexInMoreThanS) return vid;
                 }
             }
+            return -1;
         }
-        return -1;
+
+        // only count
+        if(!result.vertexCliquesEnabled) {
+            for(auto vid : R) {
+                if(++result.vertexCliqueCounts[vid] > s) {
+                    result.vertexInMoreThanSCliques = vid;
+                    if(stopAfterOneVertexInMoreThanS) return vid;
+                }
+            }
+            return -1;
+        }
+
+        // count
+        for(auto vid : R) {
+            auto& list = result.vertexCliques.at(vid);
+            list.push_back(cliqueIndex);
+            if(list.size() > s) {
+                result.vertexInMoreThanSCliques = vid;
+                if(stopAfterOneVertexInMoreThanS) return vid;
+            }
+        }
+    }
+    return -1;
+}
+
+/** Bron-Kerbosch with Pivot.
+ * Returns -1 if there was no vertex found in more than `s` cliques, otherwise the vertex id (if s=0 then always returns -1).
+ * [Eppstein et al. 2010 - Listing All Maximal Cliques in Sparse Graphs in Near-optimal Time, Figure 2: BronKerboschPivot]
+ */
+int BronKerboschPivot(Graph* G, MaximalCliquesInfo& result, size_t s, bool stopAfterOneVertexInMoreThanS
+#ifndef GRAPH_H_MATRIX_AND_LIST
+    , std::unordered_set<int>& P, std::unordered_set<int>& R, std::unordered_set<int>& X
+#else
+    , std::vector<int>& P, std::vector<int>& R, std::vector<int>& X
+#endif
+) {
+    // if $P \cup X = \emptyset$
+    if(P.empty() && X.empty()) {
+        return BronKerboschReport(result, s, stopAfterOneVertexInMoreThanS, R);
     }
 
     // choose a pivot $u \in P \cup X$. Tomita et al. 2006: choose $u$ to maximize $|P \cap N(u)|$ with $N(u)$ being the neighborhood of $u$
@@ -220,15 +315,18 @@ int BronKerboschPivot(Graph* G, MaximalCliquesInfo& result, size_t s, bool stopA
     int pivot = !P.empty() ? *P.begin() : *X.begin();
     size_t pivotValue = 0;
     for(int vid : P) {
-        const auto neighbors = G->neighbors(vid);
+        // no vertex can have more than |P| neighbors in P
+        if(pivotValue >= P.size()) break;
+
+        const auto& neighbors = G->neighbors(vid);
 
         // intersection cannot be larger than |neighbors|
-        if(neighbors.size() < pivotValue) continue;
+        if(neighbors.size() <= pivotValue) continue;
 
 #ifndef GRAPH_H_MATRIX_AND_LIST
         auto value = Graph::set_intersection(neighbors, P).size();
 #else
-        auto value = Graph::sorted_intersection_unique(neighbors, P).size();
+        auto value = Graph::sorted_intersection_count(neighbors, P);
 #endif
         if(value > pivotValue) {
             pivot = vid;
@@ -236,15 +334,17 @@ int BronKerboschPivot(Graph* G, MaximalCliquesInfo& result, size_t s, bool stopA
         }
     }
     for(int vid : X) {
-        const auto neighbors = G->neighbors(vid);
+        if(pivotValue >= P.size()) break;
+
+        const auto& neighbors = G->neighbors(vid);
 
         // intersection cannot be larger than |neighbors|
-        if(neighbors.size() < pivotValue) continue;
+        if(neighbors.size() <= pivotValue) continue;
 
 #ifndef GRAPH_H_MATRIX_AND_LIST
         auto value = Graph::set_intersection(neighbors, P).size();
 #else
-        auto value = Graph::sorted_intersection_unique(neighbors, P).size();
+        auto value = Graph::sorted_intersection_count(neighbors, P);
 #endif
         if(value > pivotValue) {
             pivot = vid;
@@ -279,6 +379,7 @@ int BronKerboschPivot(Graph* G, MaximalCliquesInfo& result, size_t s, bool stopA
         const auto vertex = BronKerboschPivot(G, result, s, stopAfterOneVertexInMoreThanS,
             P_new, R, X_new
         );
+        if(result.callbackStopped) return -1;
         if(vertex >= 0) {
             result.vertexInMoreThanSCliques = vertex;
             if(stopAfterOneVertexInMoreThanS) return vertex;
@@ -307,12 +408,423 @@ int BronKerboschPivot(Graph* G, MaximalCliquesInfo& result, size_t s, bool stopA
     return -1;
 }
 
+#ifdef GRAPH_H_MATRIX_AND_LIST
+/** Bron-Kerbosch with Pivot on bitsets: P, X and the neighborhoods are bitset rows with `words` 64-bit words.
+ * The sets of the next recursion level are taken from `arena` (3 * words per level), so the recursion does not allocate.
+ * Visits the same pivots and cliques in the same order as BronKerboschPivot on sorted vectors.
+ * Returns -1 if there was no vertex found in more than `s` cliques, otherwise the vertex id (if s=0 then always returns -1).
+ * [Eppstein et al. 2010 - Listing All Maximal Cliques in Sparse Graphs in Near-optimal Time, Figure 2: BronKerboschPivot]
+ */
+int BronKerboschPivotBitset(Graph* G, MaximalCliquesInfo& result, size_t s, bool stopAfterOneVertexInMoreThanS, size_t words,
+    uint64_t* P, std::vector<int>& R, uint64_t* X, uint64_t* arena
+) {
+    const bool PEmpty = bitset_empty(P, words);
+
+    // if $P \cup X = \emptyset$
+    if(PEmpty && bitset_empty(X, words)) {
+        return BronKerboschReport(result, s, stopAfterOneVertexInMoreThanS, R);
+    }
+
+    // choose a pivot $u \in P \cup X$ to maximize $|P \cap N(u)|$ (first vertex of P, then X with the maximum)
+    // [Tomita et al. 2006 - The worst-case time complexity for generating all maximal cliques and computational experiments]
+    int pivot = -1;
+    size_t pivotValue = 0;
+    auto pivotCandidate = [G, P, words, &pivot, &pivotValue](int vid) {
+        if(pivot < 0) pivot = vid;
+        auto value = bitset_and_count(G->neighbors_row(vid), P, words);
+        if(value > pivotValue) {
+            pivot = vid;
+            pivotValue = value;
+        }
+    };
+    if(!PEmpty) bitset_foreach(P, words, pivotCandidate);
+    bitset_foreach(X, words, pivotCandidate);
+
+    // sets of the next recursion level
+    uint64_t* loopSet = arena;
+    uint64_t* P_new = arena + words;
+    uint64_t* X_new = arena + 2 * words;
+
+    // for each vertex $v \in P \setminus N(u)$ do
+    bitset_andnot(loopSet, P, G->neighbors_row(pivot), words);
+    for(size_t i=0; i<words; ++i) {
+        for(uint64_t bits = loopSet[i]; bits; bits &= bits - 1) {
+            const int vid = i * 64 + __builtin_ctzll(bits);
+            const uint64_t* neighbors = G->neighbors_row(vid);
+
+            bitset_and(P_new, P, neighbors, words);
+            bitset_and(X_new, X, neighbors, words);
+            R.push_back(vid);
+
+            // BronKerboschPivot(P \cap N(v), R \cup \{v\}, X \cap N(v))
+            const auto vertex = BronKerboschPivotBitset(G, result, s, stopAfterOneVertexInMoreThanS, words,
+                P_new, R, X_new, arena + 3 * words
+            );
+            if(result.callbackStopped) return -1;
+            if(vertex >= 0) {
+                result.vertexInMoreThanSCliques = vertex;
+                if(stopAfterOneVertexInMoreThanS) return vertex;
+            }
+
+            // do not have to copy R
+            R.pop_back();
+
+            // P \leftarrow P \setminus \{v\}
+            bitset_reset(P, vid);
+
+            // X \leftarrow X \cup \{v\}
+            bitset_set(X, vid);
+        }
+    }
+    return -1;
+}
+
+/** Bron-Kerbosch with Pivot for graphs with n <= 64: P, X and the neighborhoods `rows` are single 64-bit words.
+ * P and X are passed by value, so the recursion only uses the stack.
+ * Visits the same pivots and cliques in the same order as BronKerboschPivot on sorted vectors.
+ * Returns -1 if there was no vertex found in more than `s` cliques, otherwise the vertex id (if s=0 then always returns -1).
+ * [Eppstein et al. 2010 - Listing All Maximal Cliques in Sparse Graphs in Near-optimal Time, Figure 2: BronKerboschPivot]
+ */
+int BronKerboschPivotWord(const uint64_t* rows, MaximalCliquesInfo& result, size_t s, bool stopAfterOneVertexInMoreThanS,
+    uint64_t P, std::vector<int>& R, uint64_t X
+) {
+    // if $P \cup X = \emptyset$
+    if(!(P | X)) {
+        return BronKerboschReport(result, s, stopAfterOneVertexInMoreThanS, R);
+    }
+
+    // choose a pivot $u \in P \cup X$ to maximize $|P \cap N(u)|$ (first vertex of P, then X with the maximum)
+    // [Tomita et al. 2006 - The worst-case time complexity for generating all maximal cliques and computational experiments]
+    const int PSize = __builtin_popcountll(P);
+    int pivot = -1;
+    int pivotValue = -1;
+    for(uint64_t candidates = P; candidates && pivotValue < PSize; candidates &= candidates - 1) {
+        const int vid = __builtin_ctzll(candidates);
+        const int value = __builtin_popcountll(rows[vid] & P);
+        if(value > pivotValue) {
+            pivot = vid;
+            pivotValue = value;
+        }
+    }
+    for(uint64_t candidates = X; candidates && pivotValue < PSize; candidates &= candidates - 1) {
+        const int vid = __builtin_ctzll(candidates);
+        const int value = __builtin_popcountll(rows[vid] & P);
+        if(value > pivotValue) {
+            pivot = vid;
+            pivotValue = value;
+        }
+    }
+
+    // for each vertex $v \in P \setminus N(u)$ do
+    for(uint64_t loopSet = P & ~rows[pivot]; loopSet; loopSet &= loopSet - 1) {
+        const int vid = __builtin_ctzll(loopSet);
+        const uint64_t bit = uint64_t(1) << vid;
+        R.push_back(vid);
+
+        // BronKerboschPivot(P \cap N(v), R \cup \{v\}, X \cap N(v))
+        const auto vertex = BronKerboschPivotWord(rows, result, s, stopAfterOneVertexInMoreThanS, P & rows[vid], R, X & rows[vid]);
+        if(result.callbackStopped) return -1;
+        if(vertex >= 0) {
+            result.vertexInMoreThanSCliques = vertex;
+            if(stopAfterOneVertexInMoreThanS) return vertex;
+        }
+
+        // do not have to copy R
+        R.pop_back();
+
+        // P \leftarrow P \setminus \{v\}
+        P &= ~bit;
+
+        // X \leftarrow X \cup \{v\}
+        X |= bit;
+    }
+    return -1;
+}
+
+/** get maximal cliques using Bron-Kerbosch based on degeneracy by Eppstein, Loeffler and Strash for graphs with n <= 64 (single word rows).
+ * Returns -1 if there was no vertex found in more than `s` cliques, otherwise the vertex id (if s=0 then always returns -1).
+ * [Eppstein et al. 2010 - Listing All Maximal Cliques in Sparse Graphs in Near-optimal Time, Figure 4: BronKerboschDegeneracy]
+ */
+int BronKerboschDegeneracyWord(Graph* G, MaximalCliquesInfo& result, size_t s, bool stopAfterOneVertexInMoreThanS) {
+    const DegeneracyOrderingScratch degeneracyScratch = DegeneracyOrderingScratch(G);
+    const auto& degeneracyInfo = *degeneracyScratch;
+    const uint64_t* rows = G->rows();
+
+    // vertices later in the ordering
+    uint64_t later = G->n() == 64 ? ~uint64_t(0) : (uint64_t(1) << G->n()) - 1;
+
+    std::vector<int> R = std::vector<int>();
+    R.reserve(degeneracyInfo.degeneracy + 1);
+
+    // for each vertex vi in a degeneracy ordering $v_0, v_1, v_2, \dots$ of $(V,E)$ do
+    for(const int vid : degeneracyInfo.ordering) {
+        later &= ~(uint64_t(1) << vid);
+
+        // R = \{vid\}
+        R.clear();
+        R.push_back(vid);
+
+        // $ P \leftarrow N(v_i) \cap \{v_{i+1}, \dots, v_{n-1}\}$, $ X \leftarrow N(v_i) \cap \{v_0, \dots, v_{i-1}\}$
+        const auto vertex = BronKerboschPivotWord(rows, result, s, stopAfterOneVertexInMoreThanS, rows[vid] & later, R, rows[vid] & ~later);
+        if(result.callbackStopped) return -1;
+        if(vertex >= 0) {
+            result.vertexInMoreThanSCliques = vertex;
+            if(stopAfterOneVertexInMoreThanS) return vertex;
+        }
+    }
+    return -1;
+}
+
+/** get maximal cliques using Bron-Kerbosch based on degeneracy by Eppstein, Loeffler and Strash, with P and X as bitsets.
+ * Returns -1 if there was no vertex found in more than `s` cliques, otherwise the vertex id (if s=0 then always returns -1).
+ * [Eppstein et al. 2010 - Listing All Maximal Cliques in Sparse Graphs in Near-optimal Time, Figure 4: BronKerboschDegeneracy]
+ */
+int BronKerboschDegeneracyBitset(Graph* G, MaximalCliquesInfo& result, size_t s, bool stopAfterOneVertexInMoreThanS) {
+    const DegeneracyOrderingScratch degeneracyScratch = DegeneracyOrderingScratch(G);
+    const auto& degeneracyInfo = *degeneracyScratch;
+    const size_t words = G->bits_words();
+
+    // P, X, vertices later in the ordering + 3 sets for every recursion level.
+    // A clique in P has at most degeneracy vertices, so there are at most degeneracy+1 levels
+    BitsetVector sets = BitsetVector((3 + 3 * (degeneracyInfo.degeneracy + 2)) * words, 0);
+    uint64_t* P = sets.data();
+    uint64_t* X = P + words;
+    uint64_t* later = X + words;
+    uint64_t* arena = later + words;
+
+    for(unsigned int vid=0; vid<G->n(); ++vid) bitset_set(later, vid);
+
+    std::vector<int> R = std::vector<int>();
+    R.reserve(degeneracyInfo.degeneracy + 1);
+
+    // for each vertex vi in a degeneracy ordering $v_0, v_1, v_2, \dots$ of $(V,E)$ do
+    for(const int vid : degeneracyInfo.ordering) {
+        const uint64_t* neighbors = G->neighbors_row(vid);
+        bitset_reset(later, vid);
+
+        // $ P \leftarrow N(v_i) \cap \{v_{i+1}, \dots, v_{n-1}\}$
+        bitset_and(P, neighbors, later, words);
+
+        // $ X \leftarrow N(v_i) \cap \{v_0, \dots, v_{i-1}\}$
+        bitset_andnot(X, neighbors, later, words);
+
+        // R = \{vid\}
+        R.clear();
+        R.push_back(vid);
+
+        const auto vertex = BronKerboschPivotBitset(G, result, s, stopAfterOneVertexInMoreThanS, words, P, R, X, arena);
+        if(result.callbackStopped) return -1;
+        if(vertex >= 0) {
+            result.vertexInMoreThanSCliques = vertex;
+            if(stopAfterOneVertexInMoreThanS) return vertex;
+        }
+    }
+    return -1;
+}
+
+/** call body(thread, index) for every index in [0, count) on `threads` threads (the calling thread is thread 0).
+ * Every thread starts with an equal range of indices and takes them from the front. A thread without indices
+ * steals the back half of the range of another thread, so a few expensive indices do not leave the other threads idle.
+ * Indices that were not started yet are skipped once stop() returns TRUE.
+ */
+template <typename Body, typename Stop>
+void ParallelForWorkStealing(size_t count, unsigned int threads, const Body& body, const Stop& stop) {
+    struct Range {
+        std::mutex mutex;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+    std::vector<Range> ranges(threads);
+    for(unsigned int thread=0; thread<threads; ++thread) {
+        ranges[thread].begin = count * thread / threads;
+        ranges[thread].end = count * (thread + 1) / threads;
+    }
+
+    auto worker = [&ranges, &body, &stop, count, threads](unsigned int thread) {
+        auto& own = ranges[thread];
+        while(!stop()) {
+            size_t index = count;
+            {
+                std::lock_guard<std::mutex> lock(own.mutex);
+                if(own.begin < own.end) index = own.begin++;
+            }
+            if(index < count) {
+                body(thread, index);
+                continue;
+            }
+
+            // steal the back half of another range. No new indices are created: if all ranges are empty, we are done
+            size_t stolenBegin = 0, stolenEnd = 0;
+            for(unsigned int offset=1; offset<threads && stolenBegin == stolenEnd; ++offset) {
+                auto& victim = ranges[(thread + offset) % threads];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if(victim.begin >= victim.end) continue;
+
+                stolenBegin = victim.begin + (victim.end - victim.begin) / 2;
+                stolenEnd = victim.end;
+                victim.end = stolenBegin;
+            }
+            if(stolenBegin == stolenEnd) return;
+
+            // only lock the own range after the victim is unlocked: two threads stealing from each other cannot deadlock
+            std::lock_guard<std::mutex> lock(own.mutex);
+            own.begin = stolenBegin;
+            own.end = stolenEnd;
+        }
+    };
+
+    std::vector<std::thread> workers = {};
+    for(unsigned int thread=1; thread<threads; ++thread) workers.emplace_back(worker, thread);
+    worker(0);
+    for(auto& thread : workers) thread.join();
+}
+
+/** get maximal cliques using Bron-Kerbosch based on degeneracy by Eppstein, Loeffler and Strash on several threads.
+ * The subproblems of the vertices in the degeneracy ordering are independent: they are distributed with ParallelForWorkStealing.
+ * Every thread writes its cliques into its own list. Afterwards the cliques are reported in the order of the degeneracy ordering,
+ * so `result` is the same as with one thread (if the enumeration did not stop early).
+ * With stopAfterOneVertexInMoreThanS the threads count the cliques per vertex in shared atomic counts and all threads stop
+ * once a vertex in more than s cliques is found.
+ * Returns -1 if there was no vertex found in more than `s` cliques, otherwise the vertex id (if s=0 then always returns -1).
+ * [Eppstein et al. 2010 - Listing All Maximal Cliques in Sparse Graphs in Near-optimal Time, Figure 4: BronKerboschDegeneracy]
+ */
+int BronKerboschDegeneracyParallel(Graph* G, MaximalCliquesInfo& result, size_t s, bool stopAfterOneVertexInMoreThanS, unsigned int threads) {
+    const DegeneracyOrderingScratch degeneracyScratch = DegeneracyOrderingScratch(G);
+    const auto& degeneracyInfo = *degeneracyScratch;
+    const auto& ordering = degeneracyInfo.ordering;
+    const size_t n = G->n();
+    const size_t words = G->bits_words();
+    const bool useBitsets = n <= GRAPH_H_BITSET_CLIQUES_MAX_N;
+
+    // the sorted lists are rebuilt lazily: rebuild them before the threads read them
+    if(!useBitsets) G->adjacency_lists();
+
+    // vertex id -> position in the degeneracy ordering
+    std::vector<size_t> positions(n);
+    for(size_t i=0; i<n; ++i) positions[ordering[i]] = i;
+
+    MaximalCliquesShared shared;
+    shared.vertexCliqueCounts = std::vector<std::atomic<unsigned int>>(n);
+    for(auto& count : shared.vertexCliqueCounts) count.store(0, std::memory_order_relaxed);
+    shared.vertexInMoreThanSCliques.store(-1);
+
+    // the cliques only have to be kept if they are listed, passed to the callback or their indices are stored per vertex
+    const bool keepCliques = result.cliqueListEnabled || result.pool != nullptr || result.callback != nullptr
+        || (s > 0 && result.vertexCliquesEnabled);
+
+    // per thread: found cliques, R and the bitsets (P, X + 3 sets for every recursion level)
+    struct ThreadCliques {
+        MaximalCliquesInfo info;
+        std::vector<int> R;
+        BitsetVector sets;
+    };
+    std::vector<ThreadCliques> locals(threads);
+    for(auto& local : locals) {
+        local.info.cliqueListEnabled = keepCliques;
+        local.info.vertexCliquesEnabled = false;
+        local.info.shared = &shared;
+        local.R.reserve(degeneracyInfo.degeneracy + 1);
+        if(useBitsets) local.sets = BitsetVector((2 + 3 * (degeneracyInfo.degeneracy + 2)) * words, 0);
+    }
+
+    // position in the ordering -> thread + range of its cliques in the list of the thread
+    struct RootCliques {
+        unsigned int thread = 0;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+    std::vector<RootCliques> roots(n);
+
+    auto body = [&](unsigned int thread, size_t i) {
+        auto& local = locals[thread];
+        const int vid = ordering[i];
+        const size_t begin = local.info.cliqueList.size();
+
+        // R = \{vid\}
+        local.R.clear();
+        local.R.push_back(vid);
+
+        // $ P \leftarrow N(v_i) \cap \{v_{i+1}, \dots, v_{n-1}\}$, $ X \leftarrow N(v_i) \cap \{v_0, \dots, v_{i-1}\}$
+        if(useBitsets) {
+            uint64_t* P = local.sets.data();
+            uint64_t* X = P + words;
+            std::fill(P, P + 2 * words, 0);
+            bitset_foreach(G->neighbors_row(vid), words, [&positions, P, X, i](int w) {
+                bitset_set(positions[w] > i ? P : X, w);
+            });
+            BronKerboschPivotBitset(G, local.info, s, stopAfterOneVertexInMoreThanS, words, P, local.R, X, X + words);
+        }
+        else {
+            std::vector<int> P = std::vector<int>();
+            std::vector<int> X = std::vector<int>();
+            for(const int w : G->neighbors(vid)) (positions[w] > i ? P : X).push_back(w);
+            BronKerboschPivot(G, local.info, s, stopAfterOneVertexInMoreThanS, P, local.R, X);
+        }
+
+        roots[i] = {.thread = thread, .begin = begin, .end = local.info.cliqueList.size()};
+    };
+    auto stop = [&shared, s, stopAfterOneVertexInMoreThanS]() {
+        return s > 0 && stopAfterOneVertexInMoreThanS && shared.vertexInMoreThanSCliques.load(std::memory_order_relaxed) >= 0;
+    };
+    ParallelForWorkStealing(n, threads, body, stop);
+
+    // only counted: take the shared counts
+    if(!keepCliques) {
+        for(const auto& local : locals) result.cliqueCount += local.info.cliqueCount;
+        if(s > 0 && !result.vertexCliquesEnabled) {
+            for(size_t vid=0; vid<n; ++vid) result.vertexCliqueCounts[vid] += shared.vertexCliqueCounts[vid].load(std::memory_order_relaxed);
+        }
+
+        const int vertex = shared.vertexInMoreThanSCliques.load();
+        if(vertex >= 0) {
+            result.vertexInMoreThanSCliques = vertex;
+            if(stopAfterOneVertexInMoreThanS) return vertex;
+        }
+        return -1;
+    }
+
+    // report the cliques in the order of the roots
+    for(const auto& root : roots) {
+        const auto& cliques = locals[root.thread].info.cliqueList;
+        for(size_t index=root.begin; index<root.end; ++index) {
+            const auto vertex = BronKerboschReport(result, s, stopAfterOneVertexInMoreThanS, cliques[index]);
+            if(result.callbackStopped) return -1;
+            if(vertex >= 0) {
+                result.vertexInMoreThanSCliques = vertex;
+                if(stopAfterOneVertexInMoreThanS) return vertex;
+            }
+        }
+    }
+    return -1;
+}
+#endif
+
 /** get maximal cliques using Bron-Kerbosch based on degeneracy by Eppstein, Loeffler and Strash.
  * Returns -1 if there was no vertex found in more than `s` cliques, otherwise the vertex id (if s=0 then always returns -1).
  * [Eppstein et al. 2010 - Listing All Maximal Cliques in Sparse Graphs in Near-optimal Time, Figure 4: BronKerboschDegeneracy]
  */
-int BronKerboschDegeneracyByEppsteinLoefflerStrash(Graph* G, MaximalCliquesInfo& result, size_t s, bool stopAfterOneVertexInMoreThanS) {
-    auto degeneracyInfo = G->getDegeneracyOrdering();
+int BronKerboschDegeneracyByEppsteinLoefflerStrash(Graph* G, MaximalCliquesInfo& result, size_t s, bool stopAfterOneVertexInMoreThanS,
+    unsigned int threads=1
+) {
+#ifdef GRAPH_H_MATRIX_AND_LIST
+    // threads=0: one thread per core
+    if(threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    if(threads > 1 && G->n() >= GRAPH_H_PARALLEL_CLIQUES_MIN_N) {
+        return BronKerboschDegeneracyParallel(G, result, s, stopAfterOneVertexInMoreThanS, threads);
+    }
+
+    // n <= 64: P and X fit into single words on the stack
+    if(G->bits_has()) {
+        return BronKerboschDegeneracyWord(G, result, s, stopAfterOneVertexInMoreThanS);
+    }
+    // dense rows are cheaper than sorted vectors up to a few thousand vertices
+    if(G->n() <= GRAPH_H_BITSET_CLIQUES_MAX_N) {
+        return BronKerboschDegeneracyBitset(G, result, s, stopAfterOneVertexInMoreThanS);
+    }
+#endif
+
+    const DegeneracyOrderingScratch degeneracyScratch = DegeneracyOrderingScratch(G);
+    const auto& degeneracyInfo = *degeneracyScratch;
 
     // for each vertex vi in a degeneracy ordering $v_0, v_1, v_2, \dots$ of $(V,E)$ do
     for(size_t i = 0; i < degeneracyInfo.ordering.size(); ++i) {
@@ -357,6 +869,7 @@ int BronKerboschDegeneracyByEppsteinLoefflerStrash(Graph* G, MaximalCliquesInfo&
 #endif
 
         const auto vertex = BronKerboschPivot(G, result, s, stopAfterOneVertexInMoreThanS, P, R, X);
+        if(result.callbackStopped) return -1;
         if(vertex >= 0) {
             result.vertexInMoreThanSCliques = vertex;
             if(stopAfterOneVertexInMoreThanS) return vertex;
@@ -367,9 +880,10 @@ int BronKerboschDegeneracyByEppsteinLoefflerStrash(Graph* G, MaximalCliquesInfo&
 
 /** find maximal cliques using Bron-Kerbosch based on degeneracy by Eppstein, Loeffler and Strash.
  * s>0: count number of cliques per vertex, if we found a vertex in >s maximal cliques and stopAfterOneVertexInMoreThanS=true, then stop
+ * threads>1 (0: one per core): graphs with at least GRAPH_H_PARALLEL_CLIQUES_MIN_N vertices are enumerated on several threads
  * [Eppstein et al. 2010 - Listing All Maximal Cliques in Sparse Graphs in Near-optimal Time, Figure 4: BronKerboschDegeneracy]
  */
-MaximalCliquesInfo Graph::getMaximalCliques(size_t s, bool stopAfterOneVertexInMoreThanS) {
+MaximalCliquesInfo Graph::getMaximalCliques(size_t s, bool stopAfterOneVertexInMoreThanS, unsigned int threads) {
     MaximalCliquesInfo info = MaximalCliquesInfo();
 #ifndef GRAPH_H_MATRIX_AND_LIST
     info.cliqueList = std::vector<std::unordered_set<int>>();
@@ -380,28 +894,287 @@ MaximalCliquesInfo Graph::getMaximalCliques(size_t s, bool stopAfterOneVertexInM
     info.vertexCliques = std::vector<std::vector<size_t>>(this->n(), std::vector<size_t>());
     info.vertexInMoreThanSCliques = -1;
 
-    BronKerboschDegeneracyByEppsteinLoefflerStrash(this, info, s, stopAfterOneVertexInMoreThanS);
+    BronKerboschDegeneracyByEppsteinLoefflerStrash(this, info, s, stopAfterOneVertexInMoreThanS, threads);
     return info;
 }
 
-/** returns one vertex id that is it more than s cliques (>s), otherwise return -1
+/** find maximal cliques like getMaximalCliques, but write them into the flat arrays of `pool` (cleared first).
+ * The pool keeps its memory, so reusing it for many graphs does not allocate memory for every clique.
  * [Eppstein et al. 2010 - Listing All Maximal Cliques in Sparse Graphs in Near-optimal Time, Figure 4: BronKerboschDegeneracy]
  */
-int Graph::getVertexInMoreThanSCliques(int s) {
+void Graph::getMaximalCliques(CliquePool& pool, size_t s, bool stopAfterOneVertexInMoreThanS, unsigned int threads) {
+    pool.clear();
+
+    // only count the cliques per vertex: the clique ids per vertex are built by index afterwards
     MaximalCliquesInfo info = MaximalCliquesInfo();
     info.cliqueListEnabled = false;
-#ifndef GRAPH_H_MATRIX_AND_LIST
-    info.cliqueList = std::vector<std::unordered_set<int>>();
-#else
-    info.cliqueList = std::vector<std::vector<int>>();
-#endif
-    info.vertexCliques = std::vector<std::vector<size_t>>(this->n(), std::vector<size_t>());
+    info.vertexCliquesEnabled = false;
+    info.pool = &pool;
+    info.vertexCliqueCounts = std::move(pool.vertexCliqueCounts);
+    info.vertexCliqueCounts.assign(this->n(), 0);
+    info.vertexInMoreThanSCliques = -1;
+
+    BronKerboschDegeneracyByEppsteinLoefflerStrash(this, info, s, stopAfterOneVertexInMoreThanS, threads);
+
+    pool.vertexCliqueCounts = std::move(info.vertexCliqueCounts);
+    pool.vertexInMoreThanSCliques = info.vertexInMoreThanSCliques;
+    pool.index(this->n());
+}
+
+/** find maximal cliques like getMaximalCliques(pool), but stop as soon as the graph is outside the budget
+ * (more than budget.maxCliques cliques or a clique with more than budget.maxCliqueSize vertices).
+ * Returns TRUE if the graph is inside the budget, only then the pool contains all cliques and the clique ids per vertex.
+ * The cliques are not counted per vertex: pool.vertexInMoreThanSCliques is -1.
+ * [Eppstein et al. 2010 - Listing All Maximal Cliques in Sparse Graphs in Near-optimal Time, Figure 4: BronKerboschDegeneracy]
+ */
+bool Graph::getMaximalCliques(CliquePool& pool, const CliqueBudget& budget) {
+    pool.clear();
+
+    bool inBudget = true;
+    const CliqueCallback callback = [&pool, &budget, &inBudget](const CliqueType& clique) {
+        pool.push(clique);
+        inBudget = (budget.maxCliques == 0 || pool.size() <= budget.maxCliques)
+            && (budget.maxCliqueSize == 0 || clique.size() <= budget.maxCliqueSize);
+        return inBudget;
+    };
+    this->forEachMaximalClique(callback);
+
+    if(!inBudget || pool.size() < budget.minCliques) return false;
+    pool.index(this->n());
+    return true;
+}
+
+bool CliquePool::clique_has(size_t id, int v) const {
+    if(this->bitsEnabled) return bitset_test(this->clique_bits(id), v);
+    const auto clique = this->clique(id);
+    return std::find(clique.begin(), clique.end(), v) != clique.end();
+}
+
+void CliquePool::clear() {
+    this->vertices.clear();
+    this->offsets.clear();
+    this->offsets.push_back(0);
+    this->cliqueIds.clear();
+    this->vertexOffsets.clear();
+    this->bits.clear();
+    this->vertexInMoreThanSCliques = -1;
+}
+
+// counting sort of the (clique id, vertex) pairs by vertex: O(n + total clique size)
+void CliquePool::index(size_t n) {
+    this->vertexOffsets.assign(n + 1, 0);
+    for(const int vid : this->vertices) ++this->vertexOffsets[vid + 1];
+    for(size_t vid=0; vid<n; ++vid) this->vertexOffsets[vid + 1] += this->vertexOffsets[vid];
+
+    // vertexOffsets[vid] is used as the insert position of vid and is moved back to its start afterwards
+    this->cliqueIds.resize(this->vertices.size());
+    for(size_t id=0; id<this->size(); ++id) {
+        for(const int vid : this->clique(id)) this->cliqueIds[this->vertexOffsets[vid]++] = id;
+    }
+    for(size_t vid=n; vid>0; --vid) this->vertexOffsets[vid] = this->vertexOffsets[vid - 1];
+    this->vertexOffsets[0] = 0;
+
+    if(this->bitsEnabled) {
+        this->words = bitset_words(n);
+        this->bits.assign(this->size() * this->words, 0);
+        for(size_t id=0; id<this->size(); ++id) {
+            uint64_t* row = this->bits.data() + id * this->words;
+            for(const int vid : this->clique(id)) bitset_set(row, vid);
+        }
+    }
+}
+
+/** returns one vertex id that is it more than s cliques (>s), otherwise return -1.
+ * Does not store any clique: only counts the cliques per vertex and stops at the first vertex in s+1 cliques.
+ * threads>1 (0: one per core): like getMaximalCliques, all threads stop once one of them found a vertex
+ * [Eppstein et al. 2010 - Listing All Maximal Cliques in Sparse Graphs in Near-optimal Time, Figure 4: BronKerboschDegeneracy]
+ */
+int Graph::getVertexInMoreThanSCliques(int s, unsigned int threads) {
+    MaximalCliquesInfo info = MaximalCliquesInfo();
+    info.cliqueListEnabled = false;
+    info.vertexCliquesEnabled = false;
+    info.vertexCliqueCounts = std::vector<unsigned int>(this->n(), 0);
     info.vertexInMoreThanSCliques = -1;
-    BronKerboschDegeneracyByEppsteinLoefflerStrash(this, info, s, true);
+    BronKerboschDegeneracyByEppsteinLoefflerStrash(this, info, s, true, threads);
     // std::cout << "\t\t" << __FILE__<<":"<<__LINE__<<" s="<<s<<" cliques="<<Graph::vector_tostring(info.cliqueList)<<"\n";
     return info.vertexInMoreThanSCliques;
 }
 
+/** Bron-Kerbosch with Pivot for the maximal cliques containing u: R = {u}, P = N(u), X = {} (word, bitset or sorted vector sets).
+ * Returns -1 if there was no vertex found in more than `s` cliques, otherwise the vertex id (if s=0 then always returns -1).
+ * [Eppstein et al. 2010 - Listing All Maximal Cliques in Sparse Graphs in Near-optimal Time, Figure 2: BronKerboschPivot]
+ */
+int BronKerboschContaining(Graph* G, MaximalCliquesInfo& result, int u, size_t s, bool stopAfterOneVertexInMoreThanS) {
+#ifdef GRAPH_H_MATRIX_AND_LIST
+    std::vector<int> R = {u};
+
+    if(G->bits_has()) {
+        return BronKerboschPivotWord(G->rows(), result, s, stopAfterOneVertexInMoreThanS, G->neighbors_bits(u), R, 0);
+    }
+    if(G->n() <= GRAPH_H_BITSET_CLIQUES_MAX_N) {
+        // P, X + 3 sets for every recursion level: at most deg(u)+1 levels
+        const size_t words = G->bits_words();
+        BitsetVector sets = BitsetVector((2 + 3 * (G->degree(u) + 2)) * words, 0);
+        const uint64_t* neighbors = G->neighbors_row(u);
+        std::copy(neighbors, neighbors + words, sets.begin());
+        return BronKerboschPivotBitset(G, result, s, stopAfterOneVertexInMoreThanS, words,
+            sets.data(), R, sets.data() + words, sets.data() + 2 * words
+        );
+    }
+
+    std::vector<int> P = G->neighbors(u);
+    std::vector<int> X = std::vector<int>();
+#else
+    std::unordered_set<int> R = {u};
+    std::unordered_set<int> P = G->neighbors(u);
+    std::unordered_set<int> X = std::unordered_set<int>();
+#endif
+    return BronKerboschPivot(G, result, s, stopAfterOneVertexInMoreThanS, P, R, X);
+}
+
+/** number of maximal cliques containing u, stops counting at `cap`.
+ * The maximal cliques containing u are $\{u\} \cup C$ for the maximal cliques C of $G[N(u)]$,
+ * so only the neighborhood of u is searched instead of the whole graph.
+ * [Eppstein et al. 2010 - Listing All Maximal Cliques in Sparse Graphs in Near-optimal Time, Figure 2: BronKerboschPivot]
+ */
+size_t Graph::countMaximalCliquesContaining(int u, size_t cap) {
+    // every vertex is in at least one maximal clique
+    if(cap <= 1) return cap;
+
+    // R starts with u, so u is the first vertex in more than cap-1 cliques
+    MaximalCliquesInfo info = MaximalCliquesInfo();
+    info.cliqueListEnabled = false;
+    info.vertexCliquesEnabled = false;
+    info.vertexCliqueCounts = std::vector<unsigned int>(this->n(), 0);
+
+    BronKerboschContaining(this, info, u, cap - 1, true);
+    return info.cliqueCount;
+}
+
+/** upper bound on the number of maximal cliques of any graph with n vertices, stops counting at `cap`.
+ * [Moon, Moser 1965 - On cliques in graphs]
+ */
+size_t MaximalCliquesMoonMoserBound(size_t n, size_t cap) {
+    if(n <= 1) return 1;
+    // n = 3k: 3^k, n = 3k+1: 4 * 3^{k-1}, n = 3k+2: 2 * 3^k
+    size_t bound = n % 3 == 1 ? 4 : (n % 3 == 2 ? 2 : 1);
+    for(size_t i = n % 3 == 1 ? 4 : n % 3; i < n && bound < cap; i += 3) bound *= 3;
+    return std::min(bound, cap);
+}
+
+#ifdef GRAPH_H_MATRIX_AND_LIST
+/** number of maximal cliques of $G[P]$ if $G[P]$ is complete multipartite (its complement is a disjoint union of cliques),
+ * stops counting at `cap`. Returns 0 if $G[P]$ is not complete multipartite (only checked until `cap` is reached).
+ * The maximal cliques take one vertex of every part: their number is the product of the part sizes.
+ * `rest` and `part` are scratch bitsets with `words` words.
+ */
+size_t MaximalCliquesCompleteMultipartite(const Graph* G, const uint64_t* P, size_t cap, uint64_t* rest, uint64_t* part) {
+    const size_t words = G->bits_words();
+    std::copy(P, P + words, rest);
+
+    size_t count = 1;
+    while(!bitset_empty(rest, words) && count < cap) {
+        // part of the first vertex: its non-neighbors in P (including itself)
+        int first = 0;
+        while(!rest[first / 64]) first += 64;
+        first += __builtin_ctzll(rest[first / 64]);
+        bitset_andnot(part, P, G->neighbors_row(first), words);
+
+        // every vertex of the part has the same non-neighbors
+        for(size_t i=0; i<words; ++i) {
+            for(uint64_t bits = part[i]; bits; bits &= bits - 1) {
+                const uint64_t* row = G->neighbors_row(i * 64 + __builtin_ctzll(bits));
+                for(size_t j=0; j<words; ++j) {
+                    if((P[j] & ~row[j]) != part[j]) return 0;
+                }
+            }
+        }
+
+        count *= bitset_count(part, words);
+        bitset_andnot(rest, rest, part, words);
+    }
+    return std::min(count, cap);
+}
+#endif
+
+/** certificate that every vertex is in at most s maximal cliques, without Bron-Kerbosch: O(n * deg * n/64) bitset tests.
+ * The maximal cliques containing v are the maximal cliques of $G[N(v)]$, a vertex v is certified if
+ * - deg(v) is so small that no graph with deg(v) vertices has more than s maximal cliques (deg(v) <= 4: at most deg(v)), or
+ * - $G[N(v)]$ is complete multipartite with at most s maximal cliques (if N(v) is a clique: exactly one).
+ * Returns TRUE if every vertex is certified. FALSE does not mean a vertex is in more than s cliques, then use getVertexInMoreThanSCliques.
+ */
+bool Graph::cliquesAtMostSCertified(size_t s) {
+#ifdef GRAPH_H_MATRIX_AND_LIST
+    if(s == 0) return this->n() == 0;
+
+    const size_t words = this->bits_words();
+    // scratch rows, reused between calls so the generators do not allocate them for every graph
+    thread_local BitsetVector scratch;
+    scratch.resize(2 * words);
+    for(int vid=0; vid<(int)this->n(); ++vid) {
+        if(MaximalCliquesMoonMoserBound(this->degree(vid), s+1) <= s) continue;
+
+        const size_t count = MaximalCliquesCompleteMultipartite(this, this->neighbors_row(vid), s+1, scratch.data(), scratch.data() + words);
+        if(count == 0 || count > s) return false;
+    }
+    return true;
+#else
+    (void)s;
+    return false;
+#endif
+}
+
+/** call `callback` for every maximal clique (Bron-Kerbosch based on degeneracy by Eppstein, Loeffler and Strash)
+ * without storing the cliques. The enumeration stops as soon as the callback returns FALSE.
+ * Returns FALSE if the callback stopped the enumeration.
+ * [Eppstein et al. 2010 - Listing All Maximal Cliques in Sparse Graphs in Near-optimal Time, Figure 4: BronKerboschDegeneracy]
+ */
+bool Graph::forEachMaximalClique(const CliqueCallback& callback) {
+    MaximalCliquesInfo info = MaximalCliquesInfo();
+    info.cliqueListEnabled = false;
+    info.callback = &callback;
+
+    BronKerboschDegeneracyByEppsteinLoefflerStrash(this, info, 0, false);
+    return !info.callbackStopped;
+}
+
+/** call `callback` for every maximal clique containing u, only searching the neighborhood of u (see countMaximalCliquesContaining).
+ * The enumeration stops as soon as the callback returns FALSE. Returns FALSE if the callback stopped the enumeration.
+ * [Eppstein et al. 2010 - Listing All Maximal Cliques in Sparse Graphs in Near-optimal Time, Figure 2: BronKerboschPivot]
+ */
+bool Graph::forEachMaximalCliqueContaining(int u, const CliqueCallback& callback) {
+    MaximalCliquesInfo info = MaximalCliquesInfo();
+    info.cliqueListEnabled = false;
+    info.callback = &callback;
+
+    BronKerboschContaining(this, info, u, 0, false);
+    return !info.callbackStopped;
+}
+
+#ifdef GRAPH_H_MATRIX_AND_LIST
+/** maximal cliques of the subgraph induced by the vertex set `P` (bitset with bits_words() words).
+ * If P is empty, the only maximal clique is the empty clique.
+ * [Eppstein et al. 2010 - Listing All Maximal Cliques in Sparse Graphs in Near-optimal Time, Figure 2: BronKerboschPivot]
+ */
+std::vector<std::vector<int>> Graph::getMaximalCliquesInduced(const uint64_t* P) {
+    MaximalCliquesInfo info = MaximalCliquesInfo();
+    std::vector<int> R = std::vector<int>();
+
+    if(this->bits_has()) {
+        BronKerboschPivotWord(this->rows(), info, 0, false, P[0], R, 0);
+        return info.cliqueList;
+    }
+
+    // P, X + 3 sets for every recursion level: at most |P|+1 levels
+    const size_t words = this->bits_words();
+    const size_t levels = bitset_count(P, words) + 2;
+    BitsetVector sets = BitsetVector((2 + 3 * levels) * words, 0);
+    std::copy(P, P + words, sets.begin());
+    BronKerboschPivotBitset(this, info, 0, false, words, sets.data(), R, sets.data() + words, sets.data() + 2 * words);
+    return info.cliqueList;
+}
+#endif
+
 // get all connected components of the graph
 std::vector<Graph> Graph::getComponents() const {
     // result components
@@ -519,15 +1292,15 @@ void overlappingSolutionsPropositionEdgeAdds(
         }
         else ++options.noNeighborPropositionCount;
 #else
-        if(Graph::sorted_intersection_unique(vNeighbors, wNeighbors).size() > 1) {
+        if(Graph::sorted_intersection_count_at_least(vNeighbors, wNeighbors, 2)) {
             editsUnfiltered.push_back({from: vVertex, to: wVertex, add: true});
         }
         else ++options.noNeighborPropositionCount;
-        if(Graph::sorted_intersection_unique(vNeighbors, xNeighbors).size() > 1) {
+        if(Graph::sorted_intersection_count_at_least(vNeighbors, xNeighbors, 2)) {
             editsUnfiltered.push_back({from: vVertex, to: xVertex, add: true});
         }
         else ++options.noNeighborPropositionCount;
-        if(Graph::sorted_intersection_unique(wNeighbors, xNeighbors).size() > 1) {
+        if(Graph::sorted_intersection_count_at_least(wNeighbors, xNeighbors, 2)) {
             editsUnfiltered.push_back({from: wVertex, to: xVertex, add: true});
         }
         else ++options.noNeighborPropositionCount;
@@ -753,7 +1526,7 @@ void overlappingClusterEditingFindForbiddenInU(Graph* G, size_t s, int k, Overla
                                 <<" walk="<<Graph::vector_tostring(walk)
                                 <<" edgesAdded="<<Graph::vector_tostring(edgesAdded)<<" edgesRemoved="<<Graph::vector_tostring(edgesRemoved)
                                 <<" forbidden="<<Graph::vector_tostring(forbidden)
-                                <<" subgraph edges: "<<Graph::vector_tostring(subgraph.edges)<<"\n";*/
+                                <<" subgraph edges: "<<Graph::vector_tostring(subgraph.adjacency_lists())<<"\n";*/
                             branchingForbiddenNameMaybe = "F2 in " + Graph::vector_tostring_value({uVertex, subgraph.id_get(walk[0]), subgraph.id_get(walk[1]), subgraph.id_get(walk[2]), subgraph.id_get(walk[3])});
     #endif
                         }
@@ -792,7 +1565,7 @@ void overlappingClusterEditingFindForbiddenInU(Graph* G, size_t s, int k, Overla
     #ifdef DEBUG
                         /*if(k==1 && uVertex==0) std::cout << "\t"<< __FILE__<<":"<<__LINE__<<" s="<<s<<" k="<<k<<" finding F2 with edit size "<<edits.size()
                                 <<" edgesAdded="<<Graph::vector_tostring(edgesAdded)<<" edgesRemoved="<<Graph::vector_tostring(edgesRemoved)
-                                <<" subgraph edges: "<<Graph::vector_tostring(subgraph.edges)<<"\n";*/
+                                <<" subgraph edges: "<<Graph::vector_tostring(subgraph.adjacency_lists())<<"\n";*/
     #endif
                         branchingEditsFoundSubgraph = true;
                         ++branchingFoundCount;
@@ -1139,10 +1912,145 @@ void overlappingClusterEditingFindForbiddenInU(Graph* G, size_t s, int k, Overla
     }
 }
 
+/** vertices of a forbidden subgraph around $u$ (minimalForbiddenGenerate): $u$ and for every pair of the maximal cliques of $u$
+ * one vertex in each clique that is not in the other clique, with the two vertices not adjacent.
+ * Vertices that are already in the subgraph are preferred, so the subgraph has at most (s+1)*s+1 vertices and often fewer.
+ */
+void forbiddenSubgraphFromCliques(Graph* G, size_t s, int uVertex, const std::vector<CliqueType>& cliquesOverlappingU, std::vector<int>& forbiddenVertices) {
+    const size_t forbiddenSizeMax = (s+1)*s+1;
+    const auto cliqueCount = cliquesOverlappingU.size();
+
+    forbiddenVertices.clear();
+    forbiddenVertices.reserve(forbiddenSizeMax);
+    forbiddenVertices.push_back(uVertex);
+
+    std::unordered_set<int> forbiddenVerticesSet = std::unordered_set<int>(forbiddenSizeMax);
+    forbiddenVerticesSet.insert(uVertex);
+
+    // for every pair of cliques, find one separating pair
+    for(size_t i=0; i<cliqueCount; ++i) { // O(s * s * (|cliqueA| + |cliqueB| + |cliqueA|)) = O(s^n * n)) = O(s^2 * n)
+        const auto& cliqueA = cliquesOverlappingU[i];
+
+        // find separating vertices: O(s * 3n)
+        for(size_t j=i+1; j<cliqueCount; ++j) {
+            const auto& cliqueB = cliquesOverlappingU[j];
+
+            // vertices in cliqueA but not in cliqueB. Copy in O(|cliqueA|)
+            std::unordered_set<int> verticesCliquesInA = 
+#ifndef GRAPH_H_MATRIX_AND_LIST
+                std::unordered_set<int>(cliqueA);
+#else
+                std::unordered_set<int>(cliqueA.begin(), cliqueA.end());
+#endif
+
+            // vertex in $cliqueB \setminus cliqueA$
+            int separatorB = -1;
+            // FALSE if separatorB is a new vertex added to the forbidden subgraph, otherwise TRUE
+            bool separatorBalreadyContains = false;
+
+            // increment overlapping vertices in O(|cliqueB|)
+            for(const auto v : cliqueB) {
+                // TRUE if v is in cliqueA
+                const auto inA = verticesCliquesInA.erase(v) > 0;
+
+                // does not overlap clique A
+                if(!inA) {
+                    // take if no separator found yet OR found separator doesn't exist in the found subgraph already and this one does
+                    // (minimize the size of the forbidden subgraph by choosing the same vertex multiple times if possible)
+                    auto alreadyContains = forbiddenVerticesSet.find(v) != forbiddenVerticesSet.end();
+                    if(separatorB < 0 || (!separatorBalreadyContains && alreadyContains)) {
+                        separatorB = v;
+                        separatorBalreadyContains = alreadyContains;
+                    }
+                }
+            }
+
+            // vertex in $cliqueA \setminus cliqueB$
+            int separatorA = -1;
+            // FALSE if separatorA is a new vertex added to the forbidden subgraph, otherwise TRUE
+            bool separatorAalreadyContains = false;
+
+            // find separatorA: vertex in cliqueA and not in cliqueB in O(|cliqueA|)
+            for(const auto v : verticesCliquesInA) {
+                if(G->edge_has(v, separatorB)) continue;
+
+                // take if no separator found yet OR found separator doesn't exist in the found subgraph already and this one does
+                // (minimize the size of the forbidden subgraph by choosing the same vertex multiple times if possible)
+                auto alreadyContains = forbiddenVerticesSet.find(v) != forbiddenVerticesSet.end();
+                if(separatorA < 0 || alreadyContains) {
+                    separatorA = v;
+                    separatorAalreadyContains = alreadyContains;
+                    if(alreadyContains) break;
+                }
+            }
+
+            // did not find separator vertices - should never happen. Thrown, stdout may be the graph stream of a tool
+            if(separatorA<0 || separatorB<0) {
+                throw std::runtime_error("did not find any separator for u=" + std::to_string(uVertex) + " (s=" + std::to_string(s) + ")"
+                    + " cliqueA=" + Graph::vector_tostring(cliqueA) + " cliqueB=" + Graph::vector_tostring(cliqueB)
+#ifndef GRAPH_H_MATRIX_AND_LIST
+                    + " graph edges=" + Graph::vector_tostring(G->edges_list)
+#else
+                    + " graph edges=" + Graph::vector_tostring(G->adjacency_lists())
+#endif
+                    + " cliques of u=" + Graph::vector_tostring(cliquesOverlappingU)
+                );
+            }
+
+            // save separator vertices
+            if(!separatorAalreadyContains) forbiddenVertices.push_back(separatorA);
+            forbiddenVerticesSet.insert(separatorA);
+            if(!separatorBalreadyContains) forbiddenVertices.push_back(separatorB);
+            forbiddenVerticesSet.insert(separatorB);
+        }
+    }
+}
+
+bool minimalForbiddenFromCliques(Graph* G, size_t s, OverlappingEditingOptions& options, int uVertex,
+    const std::vector<CliqueType>& cliquesOverlappingU, std::vector<int>& forbiddenVertices)
+{
+    // the found forbidden subgraph: u and one separating pair per pair of cliques
+    forbiddenSubgraphFromCliques(G, s, uVertex, cliquesOverlappingU, forbiddenVertices);
+
+    // check if we can find one of our own forbidden subgraphs
+    std::vector<std::vector<int>> forbidden = options.forbiddenMatrix ?
+        std::vector<std::vector<int>>(G->n(), std::vector<int>(G->n()))
+        : std::vector<std::vector<int>>(G->n(), std::vector<int>());
+    std::vector<std::vector<int>> edgesAdded = std::vector<std::vector<int>>();
+    std::vector<std::vector<int>> edgesRemoved = std::vector<std::vector<int>>();
+    bool branchingEditsFoundSubgraph = false;
+    bool branchingEditsFound = false;
+    std::vector<EdgeEdit> branchingEdits;
+    overlappingClusterEditingFindForbiddenInU(G, s, 0, options, uVertex, forbidden, edgesAdded, edgesRemoved,
+        branchingEditsFoundSubgraph, branchingEditsFound, branchingEdits
+    );
+    return !branchingEditsFoundSubgraph;
+}
+
+bool findMinimalForbidden(Graph* G, size_t s, OverlappingEditingOptions& options,
+    std::vector<CliqueType>& cliquesOverlappingU, std::vector<int>& forbiddenVertices, bool& prefilterDecided)
+{
+    prefilterDecided = G->cliquesAtMostSCertified(s);
+    if(prefilterDecided) return false;
+
+    // only counts the cliques and stops at the first vertex in s+1 cliques
+    const int uVertex = G->getVertexInMoreThanSCliques(s);
+    if(uVertex < 0) return false;
+
+    // if there are more than s+1 cliques, we only care about at most s+1: stop enumerating the cliques of $u$ after s+1
+    cliquesOverlappingU.clear();
+    G->forEachMaximalCliqueContaining(uVertex, [&cliquesOverlappingU, s](const CliqueType& clique) {
+        cliquesOverlappingU.push_back(clique);
+        return cliquesOverlappingU.size() < s+1;
+    });
+    return minimalForbiddenFromCliques(G, s, options, uVertex, cliquesOverlappingU, forbiddenVertices);
+}
+
 void overlappingClusterEditingSolutionsBranchAndBoundRecursion(
     Graph* G, std::vector<Graph>& result, size_t s, int k, OverlappingEditingOptions& options, unsigned int maxSolutions, 
     std::vector<std::vector<int>>& forbidden,
-    std::vector<std::vector<int>>& edgesAdded, std::vector<std::vector<int>>& edgesRemoved
+    std::vector<std::vector<int>>& edgesAdded, std::vector<std::vector<int>>& edgesRemoved,
+    CliqueIndex* cliqueIndex, CliqueCountCache* cliqueCounts
 ) {
     // budget empty
     if(k < 0) return;
@@ -1157,19 +2065,25 @@ void overlappingClusterEditingSolutionsBranchAndBoundRecursion(
     std::string branchingForbiddenName = "";
 #endif
 
-    // TODO: don't re-calculate cliques every branch? (e.g. only change cliques that overlapped the edit)
     // looking for cliques is a significant part of the time needed
     // timeTotal=5693µs, timeFindingCliques=4415µs, timeFindingForbidden=427µs, timeForbiddenCopy=0µs,
+    // options.incrementalCliques (cliqueIndex) only changes the cliques that overlapped the edit,
+    // but is experimental: it only pays off with useFellowsForbidden (see OverlappingEditingOptions)
 
     if(options.useFellowsForbidden) {
         auto start = TimeNow();
+#ifdef GRAPH_H_MATRIX_AND_LIST
+        // with a clique index the cliques are already known
+        const auto cliqueInfo = cliqueIndex == nullptr ? G->getMaximalCliques(s) : MaximalCliquesInfo();
+        uVertex = cliqueIndex == nullptr ? cliqueInfo.vertexInMoreThanSCliques : cliqueIndex->vertexInMoreThanSCliques(s);
+#else
         const auto cliqueInfo = G->getMaximalCliques(s);
-        options.timeFindingCliques += TimeDifference(start);
-
         uVertex = cliqueInfo.vertexInMoreThanSCliques;
+#endif
+        options.timeFindingCliques += TimeDifference(start);
 
         // no vertex in more than s cliques: no edits needed
-        if(cliqueInfo.vertexInMoreThanSCliques < 0) {
+        if(uVertex < 0) {
     #ifdef DEBUG
             std::cout << "\t\t" << __FILE__<<":"<<__LINE__<<" s="<<s<<" k="<<k<<" found solution\n";
     #endif
@@ -1194,17 +2108,27 @@ void overlappingClusterEditingSolutionsBranchAndBoundRecursion(
         forbiddenVerticesSet.insert(uVertex);
 
         // the clique indices overlapping the vertex
+#ifdef GRAPH_H_MATRIX_AND_LIST
+        const auto cliquesIndicesOverlappingU = cliqueIndex == nullptr ? cliqueInfo.vertexCliques[uVertex] : cliqueIndex->vertex_cliques(uVertex);
+        const auto cliqueAt = [&cliqueInfo, cliqueIndex](size_t index) -> const std::vector<int>& {
+            return cliqueIndex == nullptr ? cliqueInfo.cliqueList.at(index) : cliqueIndex->clique(index);
+        };
+#else
         const auto cliquesIndicesOverlappingU = cliqueInfo.vertexCliques[uVertex];
+        const auto cliqueAt = [&cliqueInfo](size_t index) -> const std::unordered_set<int>& {
+            return cliqueInfo.cliqueList.at(index);
+        };
+#endif
         // if there are more than s+1 cliques, we only care about at most s+1
         const auto cliqueCount = std::min(cliquesIndicesOverlappingU.size(), s+1);
 
         // for every pair of cliques, find one separating pair
         for(size_t i=0; i<cliqueCount; ++i) { // O(s * s * (|cliqueA| + |cliqueB| + |cliqueA|)) = O(s^n * n)) = O(s^2 * n)
-            const auto cliqueA = cliqueInfo.cliqueList.at(cliquesIndicesOverlappingU[i]);
+            const auto cliqueA = cliqueAt(cliquesIndicesOverlappingU[i]);
 
             // find separating vertices: O(s * 3n)
             for(size_t j=i+1; j<cliqueCount; ++j) {
-                const auto cliqueB = cliqueInfo.cliqueList.at(cliquesIndicesOverlappingU[j]);
+                const auto cliqueB = cliqueAt(cliquesIndicesOverlappingU[j]);
 
                 // vertices in cliqueA but not in cliqueB. Copy in O(|cliqueA|)
                 std::unordered_set<int> verticesCliquesInA = 
@@ -1263,7 +2187,7 @@ void overlappingClusterEditingSolutionsBranchAndBoundRecursion(
 #ifndef GRAPH_H_MATRIX_AND_LIST
                         <<"\n\tgraph edges="<<Graph::vector_tostring(G->edges_list)
 #else
-                        <<"\n\tgraph edges="<<Graph::vector_tostring(G->edges)
+                        <<"\n\tgraph edges="<<Graph::vector_tostring(G->adjacency_lists())
 #endif
                         <<"\n\tcliques="<<Graph::vector_tostring(cliqueInfo.cliqueList)
                         <<"\n";
@@ -1367,7 +2291,13 @@ void overlappingClusterEditingSolutionsBranchAndBoundRecursion(
     // find cliques, look for forbidden subgraph with fixed u
     else {
         auto startCliques = TimeNow();
+#ifdef GRAPH_H_MATRIX_AND_LIST
+        int vertexCandidate = cliqueIndex != nullptr ? cliqueIndex->vertexInMoreThanSCliques(s)
+            : cliqueCounts != nullptr ? cliqueCounts->vertexInMoreThanSCliques(s)
+            : G->getVertexInMoreThanSCliques(s);
+#else
         int vertexCandidate = G->getVertexInMoreThanSCliques(s);
+#endif
         options.timeFindingCliques += TimeDifference(startCliques);
 
         // no vertex in more than s cliques: no edits needed
@@ -1488,6 +2418,19 @@ void overlappingClusterEditingSolutionsBranchAndBoundRecursion(
             edgesRemoved.push_back({edit.from, edit.to, k});
         }
 
+#ifdef GRAPH_H_MATRIX_AND_LIST
+        // update the cliques (the child with k-1 < 0 returns immediately)
+        const size_t cliqueCheckpoint = cliqueIndex != nullptr ? cliqueIndex->checkpoint() : 0;
+        if(cliqueIndex != nullptr && k > 0) {
+            auto start = TimeNow();
+            if(edit.add) cliqueIndex->edge_added(edit.from, edit.to);
+            else cliqueIndex->edge_removed(edit.from, edit.to);
+            options.timeFindingCliques += TimeDifference(start);
+        }
+        const size_t countsCheckpoint = cliqueCounts != nullptr ? cliqueCounts->checkpoint() : 0;
+        if(cliqueCounts != nullptr) cliqueCounts->edge_changed(edit.from, edit.to);
+#endif
+
 #ifdef DEBUG
         if(0) std::cout << "\t" << __FILE__<<":"<<__LINE__<<" s="<<s<<" k="<<k<<" doing edit from="<< edit.from<<" to="<<edit.to
             <<" edgesAdded="<<Graph::vector_tostring(edgesAdded)<<" edgesRemoved="<<Graph::vector_tostring(edgesRemoved)<<"\n";
@@ -1500,10 +2443,10 @@ void overlappingClusterEditingSolutionsBranchAndBoundRecursion(
             options.timeForbiddenCopy += TimeDifference(start);
 
             overlappingClusterEditingSolutionsBranchAndBoundRecursion(G, result, s, k-1, options, maxSolutions, forbiddenCopy, 
-                edgesAdded, edgesRemoved);
+                edgesAdded, edgesRemoved, cliqueIndex, cliqueCounts);
         } else {
             overlappingClusterEditingSolutionsBranchAndBoundRecursion(G, result, s, k-1, options, maxSolutions, forbidden, 
-                edgesAdded, edgesRemoved);
+                edgesAdded, edgesRemoved, cliqueIndex, cliqueCounts);
         }
         
         // undo the edit
@@ -1514,6 +2457,10 @@ void overlappingClusterEditingSolutionsBranchAndBoundRecursion(
             G->edge_add(edit.from, edit.to);
             edgesRemoved.pop_back();
         }
+#ifdef GRAPH_H_MATRIX_AND_LIST
+        if(cliqueIndex != nullptr) cliqueIndex->rollback(cliqueCheckpoint);
+        if(cliqueCounts != nullptr) cliqueCounts->rollback(countsCheckpoint);
+#endif
 
         if(maxSolutions > 0 && result.size() >= maxSolutions) return;
 
@@ -1557,7 +2504,8 @@ int Graph::overlappingClusterEditingLowerBound(unsigned int s, int k, Overlappin
     // std::vector<bool> verticesRemoved = std::vector<bool>(n, false);
 
     // look for stars
-    auto degeneracyInfo = this->getDegeneracyOrdering(s, k);
+    const DegeneracyOrderingScratch degeneracyScratch = DegeneracyOrderingScratch(this, s, k);
+    const auto& degeneracyInfo = *degeneracyScratch;
 
     return degeneracyInfo.editBound;
 }
@@ -1651,7 +2599,25 @@ std::vector<Graph> Graph::overlappingClusterEditingSolutionsBranchAndBound(size_
         }
     }
 
-    overlappingClusterEditingSolutionsBranchAndBoundRecursion(&Copy, result, s, k, options, maxSolutions, forbidden, edgesAdded, edgesRemoved);
+#ifdef GRAPH_H_MATRIX_AND_LIST
+    // the clique index is only needed if u is found with maximal cliques
+    std::unique_ptr<CliqueIndex> cliqueIndex = nullptr;
+    if(options.incrementalCliques && (options.useFellowsForbidden || options.useForbiddenCliques)) {
+        auto startCliques = TimeNow();
+        cliqueIndex = std::make_unique<CliqueIndex>(&Copy);
+        options.timeFindingCliques += TimeDifference(startCliques);
+    }
+    // the local counts only replace getVertexInMoreThanSCliques
+    std::unique_ptr<CliqueCountCache> cliqueCounts = nullptr;
+    if(options.localCliqueCounts && cliqueIndex == nullptr && !options.useFellowsForbidden && options.useForbiddenCliques) {
+        cliqueCounts = std::make_unique<CliqueCountCache>(&Copy);
+    }
+    overlappingClusterEditingSolutionsBranchAndBoundRecursion(&Copy, result, s, k, options, maxSolutions, forbidden, edgesAdded, edgesRemoved,
+        cliqueIndex.get(), cliqueCounts.get());
+#else
+    overlappingClusterEditingSolutionsBranchAndBoundRecursion(&Copy, result, s, k, options, maxSolutions, forbidden, edgesAdded, edgesRemoved,
+        nullptr, nullptr);
+#endif
 
     options.timeTotal = TimeDifference(start);
 
@@ -1726,7 +2692,7 @@ bool Graph::edge_has(int v, int w) const {
     const auto& list = this->edges_list.at(v);
     return list.find(w) != list.end();
 #else
-    return this->edges_matrix.at(v).at(w);
+    return bitset_test(&this->edges_bits[v * this->bits_stride], w);
 #endif
 }
 
@@ -1736,10 +2702,12 @@ void Graph::edge_add(int v, int w) {
     edges_list.at(v).insert(w);
     edges_list.at(w).insert(v);
 #else
-    Graph::sorted_insert(edges.at(v), w);
-    Graph::sorted_insert(edges.at(w), v);
-    this->edges_matrix.at(v).at(w) = 1;
-    this->edges_matrix.at(w).at(v) = 1;
+    bitset_set(&this->edges_bits[v * this->bits_stride], w);
+    bitset_set(&this->edges_bits[w * this->bits_stride], v);
+
+    // the sorted lists are rebuilt in neighbors(v)
+    bitset_set(this->edges_dirty.data(), v);
+    bitset_set(this->edges_dirty.data(), w);
 #endif
     ++this->number_edges;
 }
@@ -1750,10 +2718,12 @@ void Graph::edge_remove(int v, int w) {
     edges_list.at(v).erase(w);
     edges_list.at(w).erase(v);
 #else
-    Graph::sorted_remove(edges.at(v), w);
-    Graph::sorted_remove(edges.at(w), v);
-    this->edges_matrix.at(v).at(w) = 0;
-    this->edges_matrix.at(w).at(v) = 0;
+    bitset_reset(&this->edges_bits[v * this->bits_stride], w);
+    bitset_reset(&this->edges_bits[w * this->bits_stride], v);
+
+    // the sorted lists are rebuilt in neighbors(v)
+    bitset_set(this->edges_dirty.data(), v);
+    bitset_set(this->edges_dirty.data(), w);
 #endif
     --this->number_edges;
 }
@@ -1763,7 +2733,9 @@ int Graph::degree(int v) const {
 #ifndef GRAPH_H_MATRIX_AND_LIST
     return this->edges_list.at(v).size();
 #else
-    return this->edges.at(v).size();
+    // popcount of the row: neighbors() would rebuild the list, which is not thread-safe on a const graph
+    if(this->bits_stride == 1) return __builtin_popcountll(this->edges_bits[v]);
+    return bitset_count(this->neighbors_row(v), this->bits_stride);
 #endif
 }
 
@@ -1771,10 +2743,63 @@ int Graph::degree(int v) const {
 const std::unordered_set<int>& Graph::neighbors(int v) const {
     return edges_list.at(v);
 }
+
+// returns FALSE: the adjacency is only stored as sets
+bool Graph::bits_has() const {
+    return false;
+}
+
+// returns the neighbors of v as a 64-bit word (bit w is set if the edge {v,w} exists). Only for n <= 64
+uint64_t Graph::neighbors_bits(int v) const {
+    uint64_t bits = 0;
+    for(auto w : edges_list.at(v)) bits |= uint64_t(1) << w;
+    return bits;
+}
 #else
+// returns the sorted neighbors of v. The list is rebuilt from the bitset row if an edit changed it: O(n/64 + deg(v))
 const std::vector<int>& Graph::neighbors(int v) const {
+    if(bitset_test(this->edges_dirty.data(), v)) {
+        auto& list = this->edges[v];
+        list.clear();
+        bitset_foreach(&this->edges_bits[v * this->bits_stride], this->bits_stride, [&list](int w) {
+            list.push_back(w);
+        });
+        bitset_reset(this->edges_dirty.data(), v);
+    }
     return edges.at(v);
 }
+
+// returns all sorted adjacency lists (e.g. for printing)
+const std::vector<std::vector<int>>& Graph::adjacency_lists() const {
+    for(unsigned int v=0; v<this->number_vertices; ++v) this->neighbors(v);
+    return this->edges;
+}
+
+// returns TRUE if the adjacency rows are single 64-bit words (n <= 64)
+bool Graph::bits_has() const {
+    return this->bits_stride == 1;
+}
+
+// returns the neighbors of v as a 64-bit word (bit w is set if the edge {v,w} exists). Only for n <= 64.
+// Iterate the neighbors with: for(auto bits = G.neighbors_bits(v); bits; bits &= bits - 1) { int w = __builtin_ctzll(bits); }
+uint64_t Graph::neighbors_bits(int v) const {
+    return this->edges_bits[v * this->bits_stride];
+}
+
+// returns the bitset row of v with bits_words() words
+const uint64_t* Graph::neighbors_row(int v) const {
+    return &this->edges_bits[v * this->bits_stride];
+}
+
+// returns all bitset rows: row v starts at word v * bits_words() (read only, edges are changed with edge_add/edge_remove)
+const uint64_t* Graph::rows() const {
+    return this->edges_bits.data();
+}
+
+// returns the number of 64-bit words of every bitset row
+size_t Graph::bits_words() const {
+    return this->bits_stride;
+}
 #endif
 
 // returns the mapped ID of the given vertex_id. [0,this->n()] -> [0,Parent_Graph->n()]
@@ -1810,15 +2835,105 @@ unsigned int Graph::m() const {
     return this->number_edges;
 }
 
+// graph6 and sparse6 store 6 bits per character as the character 63 + bits, the first bit is bit 5 (see formats.txt of nauty)
+
+// the 6 bits of a character in reverse order: the first bit becomes bit 0, so it can be ORed into a bitset row
+static constexpr std::array<uint8_t, 64> GRAPH6_REVERSED = [] {
+    std::array<uint8_t, 64> table = {};
+    for(int bits=0; bits<64; ++bits) {
+        for(int b=0; b<6; ++b) {
+            if((bits >> b) & 1) table[bits] |= 1 << (5 - b);
+        }
+    }
+    return table;
+}();
+
+// largest number of vertices of a graph6/sparse6 header: the bitset rows of a graph have n*n bits (512 MiB for n=65536)
+#define GRAPH6_MAX_N 65536
+
+// throws if a character of g6[begin, end) is not a graph6/sparse6 data character '?'..'~' (6 bits + 63)
+static void Graph6CharactersCheck(std::string_view g6, size_t begin, size_t end) {
+    for(size_t i=begin; i<end; ++i) {
+        if(g6[i] < 63 || g6[i] > 126) throw std::runtime_error("invalid graph6/sparse6 character at "+std::to_string(i)+": " + std::string(g6));
+    }
+}
+
+/** number of vertices of the graph6/sparse6 header at g6[idx], moves idx behind the header:
+ * n+63 (n <= 62), '~' + 3 characters (n <= 258047) or '~~' + 6 characters (n <= 68719476735).
+ * Throws for bad characters and for n > GRAPH6_MAX_N: the header alone sizes the graph (a sparse6 line can be only the header)
+ */
+static size_t Graph6HeaderRead(std::string_view g6, size_t& idx) {
+    size_t characters = 1;
+    if(idx < g6.size() && g6[idx] == '~') {
+        characters = idx + 1 < g6.size() && g6[idx + 1] == '~' ? 6 : 3;
+        idx += characters == 6 ? 2 : 1;
+    }
+    if(g6.size() < idx + characters) throw std::runtime_error("graph6/sparse6 header is too short: " + std::string(g6));
+    Graph6CharactersCheck(g6, idx, idx + characters);
+
+    size_t n = 0;
+    for(size_t i=0; i<characters; ++i) n = (n << 6) | (size_t)(g6[idx++] - 63);
+    if(n > GRAPH6_MAX_N) throw std::runtime_error("graph6/sparse6 header: n="+std::to_string(n)+" is too large: " + std::string(g6.substr(0, idx)));
+    return n;
+}
+
+// append the graph6/sparse6 header of n vertices
+static void Graph6HeaderWrite(std::string& g6, size_t n) {
+    size_t characters = 1;
+    if(n > 258047) {
+        g6 += "~~";
+        characters = 6;
+    }
+    else if(n > 62) {
+        g6 += '~';
+        characters = 3;
+    }
+    for(size_t i=characters; i-- > 0;) g6.push_back(static_cast<char>(63 + ((n >> (6 * i)) & 63)));
+}
+
+// length of the optional prefix (e.g. ">>graph6<<") of a line
+static size_t Graph6PrefixLength(std::string_view g6, std::string_view prefix) {
+    return g6.substr(0, prefix.size()) == prefix ? prefix.size() : 0;
+}
+
+// bits per vertex id in sparse6: the number of bits of n-1
+static size_t Sparse6Bits(size_t n) {
+    size_t k = 0;
+    while(((size_t)1 << k) < n) ++k;
+    return k;
+}
+
 // parse a graph from a graph6 string
 Graph Graph::parse_graph6(const std::string& g6) {
-    size_t idx = 0;
+    Graph G(0);
+    G.assign_graph6(g6);
+    return G;
+}
+
+// parse a graph from a sparse6 string
+Graph Graph::parse_sparse6(const std::string& s6) {
+    Graph G(0);
+    G.assign_sparse6(s6);
+    return G;
+}
+
+/** replace this graph by the graph of a graph6 string (short, long and extra long headers). Keeps the storage of the previous graph:
+ * parsing the lines of a stream into the same Graph does not allocate if the number of vertices stays the same.
+ * The 6 bits of a character are ORed into the bitset rows at once, only the symmetric bits are set per edge.
+ */
+void Graph::assign_graph6(std::string_view g6) {
+    size_t idx = Graph6PrefixLength(g6, ">>graph6<<");
 
-    // number of vertices = first character
-    int n = g6[idx++] - 63;
+    // number of vertices = header
+    const int n = Graph6HeaderRead(g6, idx);
+    const size_t end = idx + ((size_t)n * (n - 1) / 2 + 5) / 6;
+    if(g6.size() < end) throw std::runtime_error("graph6 string is too short: " + std::string(g6));
+    // the characters index GRAPH6_REVERSED: checked before anything is decoded
+    Graph6CharactersCheck(g6, idx, end);
 
-    Graph G(n);
+    this->assign_empty(n);
 
+#ifndef GRAPH_H_MATRIX_AND_LIST
     // adjacency bits = other characters
     int bit_buffer = 0;
     int bit_count = 0;
@@ -1829,30 +2944,150 @@ Graph Graph::parse_graph6(const std::string& g6) {
                 bit_count = 6;
             }
             bit_count--;
-            int bit = (bit_buffer >> bit_count) & 1;
-
-            if(bit==1) {
-                G.edge_add(i, j);
+            if((bit_buffer >> bit_count) & 1) this->edge_add(i, j);
+        }
+    }
+#else
+    // adjacency bits = other characters: row i gets the bits of the edges {i, j} with j < i
+    int bit_buffer = 0;
+    int bit_count = 0;
+    for (int i = 1; i < n; ++i) {
+        uint64_t* row = &this->edges_bits[i * this->bits_stride];
+        for (int j = 0; j < i;) {
+            if (bit_count == 0) {
+                bit_buffer = GRAPH6_REVERSED[g6[idx++] - 63];
+                bit_count = 6;
             }
+            // the next bits of the character, without crossing the end of the row or a word
+            const int take = std::min({bit_count, i - j, 64 - j % 64});
+            row[j / 64] |= (uint64_t)(bit_buffer & ((1 << take) - 1)) << (j % 64);
+            bit_buffer >>= take;
+            bit_count -= take;
+            j += take;
         }
     }
 
-    return G;
+    this->rows_symmetric();
+#endif
 }
 
-// create a graph6 from this graph
-std::string Graph::to_graph6() const {
-    int n = this->n();
-    std::string g6;
+/** replace this graph by n vertices and the packed lower triangle `bits` (edges {i, j} with j < i in graph6 order,
+ * edge p is bit p % 8 of byte p / 8). Keeps the storage like assign_graph6, the rows are filled a byte at a time.
+ */
+void Graph::assign_triangle_bits(int n, const uint8_t* bits) {
+    this->assign_empty(n);
+
+#ifndef GRAPH_H_MATRIX_AND_LIST
+    size_t p = 0;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < i; ++j, ++p) {
+            if((bits[p / 8] >> (p % 8)) & 1) this->edge_add(i, j);
+        }
+    }
+#else
+    size_t p = 0;
+    for (int i = 1; i < n; ++i) {
+        uint64_t* row = &this->edges_bits[i * this->bits_stride];
+        for (int j = 0; j < i;) {
+            // the next bits of the byte, without crossing the end of the row or a word
+            const int take = std::min({8 - (int)(p % 8), i - j, 64 - j % 64});
+            row[j / 64] |= (uint64_t)((bits[p / 8] >> (p % 8)) & ((1 << take) - 1)) << (j % 64);
+            p += take;
+            j += take;
+        }
+    }
+    this->rows_symmetric();
+#endif
+}
+
+/** write the packed lower triangle (see assign_triangle_bits) to `bits`: triangle_bytes(n) bytes, the unused bits are zero */
+void Graph::triangle_bits(uint8_t* bits) const {
+    const int n = this->n();
+    std::fill(bits, bits + Graph::triangle_bytes(n), 0);
+
+#ifndef GRAPH_H_MATRIX_AND_LIST
+    size_t p = 0;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < i; ++j, ++p) {
+            if(this->edge_has(i, j)) bits[p / 8] |= 1 << (p % 8);
+        }
+    }
+#else
+    size_t p = 0;
+    for (int i = 1; i < n; ++i) {
+        const uint64_t* row = &this->edges_bits[i * this->bits_stride];
+        for (int j = 0; j < i;) {
+            const int take = std::min({8 - (int)(p % 8), i - j, 64 - j % 64});
+            bits[p / 8] |= ((row[j / 64] >> (j % 64)) & ((1u << take) - 1)) << (p % 8);
+            p += take;
+            j += take;
+        }
+    }
+#endif
+}
 
-    // graph6 only supports n <= 62 in the single-character format
-    if (n > 62) {
-        throw std::runtime_error("graph6 encoding for n > 62 not implemented");
+// bytes of the packed lower triangle of a graph with n vertices
+size_t Graph::triangle_bytes(size_t n) {
+    return (n * (n - (n > 0)) / 2 + 7) / 8;
+}
+
+/** replace this graph by the graph of a sparse6 string (":" + header + edges), keeps the storage like assign_graph6.
+ * Every edge is a bit b (1: next vertex v) and a vertex id x with k bits: x > v sets v=x, otherwise it is the edge {x, v}.
+ * Loops and multiple edges are ignored, the incremental format (";") is not supported. Bad characters are thrown.
+ */
+void Graph::assign_sparse6(std::string_view s6) {
+    size_t idx = Graph6PrefixLength(s6, ">>sparse6<<");
+    if(idx >= s6.size() || s6[idx] != ':') throw std::runtime_error("sparse6 string has to start with ':': " + std::string(s6));
+    ++idx;
+
+    const size_t n = Graph6HeaderRead(s6, idx);
+    const size_t k = Sparse6Bits(n);
+    Graph6CharactersCheck(s6, idx, s6.size());
+    this->assign_empty(n);
+
+    // current character and its bits that were not read yet
+    int bit_buffer = 0;
+    int bit_count = 0;
+    size_t v = 0;
+    while(v < n) {
+        if(bit_count == 0) {
+            if(idx >= s6.size()) break;
+            bit_buffer = s6[idx++] - 63;
+            bit_count = 6;
+        }
+        const bool b = (bit_buffer >> --bit_count) & 1;
+
+        // k bits of x, as many as possible per character. The padding at the end can leave x incomplete
+        size_t x = 0;
+        size_t need = k;
+        while(need > 0 && (bit_count > 0 || idx < s6.size())) {
+            if(bit_count == 0) {
+                bit_buffer = s6[idx++] - 63;
+                bit_count = 6;
+            }
+            const int take = std::min((size_t)bit_count, need);
+            bit_count -= take;
+            x = (x << take) | ((bit_buffer >> bit_count) & ((1 << take) - 1));
+            need -= take;
+        }
+        if(need > 0) break;
+
+        if(b) ++v;
+        if(x > v) v = x;
+        else if(v < n && x != v && !this->edge_has(x, v)) this->edge_add(x, v);
     }
+}
+
+// create a graph6 from this graph (long headers for n > 62)
+std::string Graph::to_graph6() const {
+    const int n = this->n();
+    std::string g6;
+    g6.reserve(8 + ((size_t)n * (n - 1) / 2 + 5) / 6);
 
-    // first character: number of vertices
-    g6.push_back(static_cast<char>(n + 63));
+    // first characters: number of vertices
+    Graph6HeaderWrite(g6, n);
 
+#ifndef GRAPH_H_MATRIX_AND_LIST
     int bit_buffer = 0;
     int bit_count = 0;
 
@@ -1877,10 +3112,130 @@ std::string Graph::to_graph6() const {
         bit_buffer <<= (6 - bit_count);
         g6.push_back(static_cast<char>(bit_buffer + 63));
     }
+#else
+    // the bits of row i with j < i in row order (first bit = bit 0), reversed per character
+    int bit_buffer = 0;
+    int bit_count = 0;
+    for (int i = 1; i < n; ++i) {
+        const uint64_t* row = &this->edges_bits[i * this->bits_stride];
+        for (int j = 0; j < i;) {
+            const int take = std::min({6 - bit_count, i - j, 64 - j % 64});
+            bit_buffer |= (int)((row[j / 64] >> (j % 64)) & ((1u << take) - 1)) << bit_count;
+            bit_count += take;
+            j += take;
+
+            if (bit_count == 6) {
+                g6.push_back(static_cast<char>(GRAPH6_REVERSED[bit_buffer] + 63));
+                bit_buffer = 0;
+                bit_count = 0;
+            }
+        }
+    }
+
+    // flush remaining bits (the missing bits are zeros on the right)
+    if (bit_count > 0) g6.push_back(static_cast<char>(GRAPH6_REVERSED[bit_buffer] + 63));
+#endif
 
     return g6;
 }
 
+// create a sparse6 from this graph: O(n + m) characters instead of O(n^2) for graph6
+std::string Graph::to_sparse6() const {
+    const size_t n = this->n();
+    const size_t k = Sparse6Bits(n);
+    std::string s6 = ":";
+    Graph6HeaderWrite(s6, n);
+
+    int bit_buffer = 0;
+    int bit_count = 0;
+    // append the lowest `count` bits of value, highest bit first
+    auto bitsWrite = [&s6, &bit_buffer, &bit_count](size_t value, size_t count) {
+        for(size_t i=count; i-- > 0;) {
+            bit_buffer = (bit_buffer << 1) | ((value >> i) & 1);
+            if(++bit_count == 6) {
+                s6.push_back(static_cast<char>(bit_buffer + 63));
+                bit_buffer = 0;
+                bit_count = 0;
+            }
+        }
+    };
+
+    // edges {i, v} with i < v ordered by v, v is the current vertex of the decoder
+    size_t v = 0;
+    for(size_t j=0; j<n; ++j) {
+#ifndef GRAPH_H_MATRIX_AND_LIST
+        std::vector<int> neighbors = std::vector<int>(this->neighbors(j).begin(), this->neighbors(j).end());
+        std::sort(neighbors.begin(), neighbors.end());
+#else
+        const auto& neighbors = this->neighbors(j);
+#endif
+        for(const int i : neighbors) {
+            if((size_t)i >= j) break;
+
+            if(j == v) bitsWrite(0, 1);
+            else {
+                // next vertex, jump to j with x = j > v
+                bitsWrite(1, 1);
+                if(j > v + 1) {
+                    bitsWrite(j, k);
+                    bitsWrite(0, 1);
+                }
+                v = j;
+            }
+            bitsWrite(i, k);
+        }
+    }
+
+    // pad with 1 bits: "next vertex" with x >= n ends the decoding.
+    // If n = 2^k and v = n-2, the 1 bit would make v = n-1 and x = n-1 a loop: then start the padding with a 0 bit
+    if(bit_count > 0) {
+        const int pad = 6 - bit_count;
+        if((size_t)pad >= k + 1 && v + 2 == n && n == ((size_t)1 << k)) bit_buffer = (bit_buffer << pad) | ((1 << (pad - 1)) - 1);
+        else bit_buffer = (bit_buffer << pad) | ((1 << pad) - 1);
+        s6.push_back(static_cast<char>(bit_buffer + 63));
+    }
+    return s6;
+}
+
+#ifdef GRAPH_H_MATRIX_AND_LIST
+// set the symmetric bits of the edges {i, j} with j < i (rows only contain the lower triangle) and count the edges
+void Graph::rows_symmetric() {
+    for (unsigned int i = 1; i < this->number_vertices; ++i) {
+        const uint64_t* row = &this->edges_bits[i * this->bits_stride];
+        for(size_t word=0; word <= (size_t)(i - 1) / 64; ++word) {
+            for(uint64_t bits = row[word]; bits; bits &= bits - 1) {
+                bitset_set(&this->edges_bits[(word * 64 + __builtin_ctzll(bits)) * this->bits_stride], i);
+                ++this->number_edges;
+            }
+        }
+    }
+}
+#endif
+
+/** replace this graph by n vertices without edges. Keeps the storage (rows and list capacities) of the previous graph */
+void Graph::assign_empty(int n) {
+    this->number_vertices = n;
+    this->number_edges = 0;
+    this->ids_initialized = false;
+    this->ids.clear();
+    this->ids_reverse.clear();
+
+#ifndef GRAPH_H_MATRIX_AND_LIST
+    this->edges_list.resize(n);
+    for(auto& list : this->edges_list) list.clear();
+#else
+    // the lists are rebuilt from the rows when needed (keeping their capacity)
+    this->edges.resize(n);
+    this->edges_dirty.assign(bitset_words(n), ~uint64_t(0));
+#ifdef GRAPH_H_BITSET_SMALL
+    this->bits_stride = n <= 64 ? 1 : bitset_words_aligned(n);
+#else
+    this->bits_stride = bitset_words_aligned(n);
+#endif
+    this->edges_bits.assign((size_t)n * this->bits_stride, 0);
+#endif
+}
+
 // constructor initializing adjacency lists
 Graph::Graph(int n) {
     this->number_vertices = n;
@@ -1892,7 +3247,13 @@ Graph::Graph(int n) {
     this->edges_list.assign(n, std::unordered_set<int>(n));
 #else
     this->edges.assign(n, std::vector<int>());
-    this->edges_matrix.assign(n, std::vector<bool>(n, false));
+    this->edges_dirty.assign(bitset_words(n), 0);
+#ifdef GRAPH_H_BITSET_SMALL
+    this->bits_stride = n <= 64 ? 1 : bitset_words_aligned(n);
+#else
+    this->bits_stride = bitset_words_aligned(n);
+#endif
+    this->edges_bits.assign((size_t)n * this->bits_stride, 0);
 #endif
 }
 
@@ -1914,12 +3275,11 @@ Graph::Graph(const Graph* G) {
         this->edges_list[i] = std::unordered_set<int>(G->edges_list[i]);
     }
 #else
+    // copy only the bitset rows: the lists are rebuilt when needed
+    this->bits_stride = G->bits_stride;
+    this->edges_bits = BitsetVector(G->edges_bits);
     this->edges = std::vector<std::vector<int>>(this->number_vertices);
-    this->edges_matrix = std::vector<std::vector<bool>>(this->number_vertices);
-    for(size_t i=0; i<this->number_vertices; ++i) {
-        this->edges[i] = std::vector<int>(G->edges[i]);
-        this->edges_matrix[i] = std::vector<bool>(G->edges_matrix[i]);
-    }
+    this->edges_dirty.assign(bitset_words(this->number_vertices), ~uint64_t(0));
 #endif
 }
 
@@ -2016,6 +3376,68 @@ std::vector<int> Graph::sorted_difference(const std::vector<int>& a, const std::
     return Graph::sorted_difference_slice(a, 0, a.size(), b, 0, b.size());
 }
 
+// galloping instead of merging if one vector is this many times larger than the other
+// [Demaine et al. 2000 - Adaptive set intersections, unions, and differences]
+const size_t SORTED_GALLOP_RATIO = 32;
+
+// first index i >= from with vec[i] >= x: exponential search from `from`, then binary search in the last step
+static size_t sortedGallop(const std::vector<int>& vec, size_t from, int x) {
+    size_t step = 1;
+    size_t hi = from;
+    while(hi < vec.size() && vec[hi] < x) {
+        from = hi + 1;
+        hi += step;
+        step *= 2;
+    }
+    hi = std::min(hi, vec.size());
+    return std::lower_bound(vec.begin() + from, vec.begin() + hi, x) - vec.begin();
+}
+
+// number of elements in both `small` and `large`, counting up to `k` (stops early). Gallops through `large`.
+static size_t sortedIntersectionCountGallop(const std::vector<int>& small, const std::vector<int>& large, size_t k) {
+    size_t count = 0;
+    size_t j = 0;
+    for(size_t i=0; i<small.size() && count < k; ++i) {
+        j = sortedGallop(large, j, small[i]);
+        if(j >= large.size()) break;
+        if(large[j] == small[i]) ++count;
+    }
+    return count;
+}
+
+// |a \cap b| of two sorted vectors without creating the intersection. Assumes unique elements.
+size_t Graph::sorted_intersection_count(const std::vector<int>& a, const std::vector<int>& b) {
+    const auto& small = a.size() <= b.size() ? a : b;
+    const auto& large = a.size() <= b.size() ? b : a;
+    if(small.empty()) return 0;
+    if(small.size() * SORTED_GALLOP_RATIO < large.size()) return sortedIntersectionCountGallop(small, large, SIZE_MAX);
+    return setKernels.sorted_intersection_count(a.data(), a.size(), b.data(), b.size());
+}
+
+// TRUE if |a \cap b| >= k. Stops as soon as k common elements are found or k cannot be reached anymore. Assumes unique elements.
+bool Graph::sorted_intersection_count_at_least(const std::vector<int>& a, const std::vector<int>& b, size_t k) {
+    if(k == 0) return true;
+    const auto& small = a.size() <= b.size() ? a : b;
+    const auto& large = a.size() <= b.size() ? b : a;
+    if(small.size() < k) return false;
+    if(small.size() * SORTED_GALLOP_RATIO < large.size()) return sortedIntersectionCountGallop(small, large, k) >= k;
+
+    size_t count = 0;
+    size_t i = 0;
+    size_t j = 0;
+    while(i < a.size() && j < b.size()) {
+        // not enough elements left to reach k
+        if(count + std::min(a.size() - i, b.size() - j) < k) return false;
+
+        const int x = a[i];
+        const int y = b[j];
+        i += x <= y;
+        j += x >= y;
+        if(x == y && ++count >= k) return true;
+    }
+    return false;
+}
+
 // merges two sorted vectors: elements in either `a` and `b`. Using the index slices [aFrom,aTo) and [bFrom,bTo).
 std::vector<int> Graph::sorted_union_unique_slice(const std::vector<int>& a, size_t aFrom, size_t aTo, const std::vector<int>& b, size_t bFrom, size_t bTo) {
     std::vector<int> list = std::vector<int>();
@@ -2057,81 +3479,23 @@ std::vector<int> Graph::sorted_union_unique_slice(const std::vector<int>& a, siz
 
 // intersect two sorted vectors: elements in both `a` and `b`. Assumes unique elements. Using the index slices [aFrom,aTo) and [bFrom,bTo).
 std::vector<int> Graph::sorted_intersection_unique_slice(const std::vector<int>& a, size_t aFrom, size_t aTo, const std::vector<int>& b, size_t bFrom, size_t bTo) {
-    std::vector<int> list = std::vector<int>();
-
-    size_t i=aFrom;
-    size_t j=bFrom;
-
-    int elementA = i < aTo ? a[i] : INT32_MAX;
-    int elementB = j < bTo ? b[j] : INT32_MAX;
-
-    // && here since can only intersect as long as we have elements from both
-    while(i < aTo && j < bTo) {
-        if(elementA == elementB) {
-            list.push_back(elementA);
-            ++i;
-            ++j;
-            if(i < aTo) elementA = a[i];
-            else elementA = INT32_MAX;
-
-            if(j < bTo) elementB = b[j];
-            else elementB = INT32_MAX;
-        }
-        else if(elementA < elementB) {
-            ++i;
-            if(i < aTo) elementA = a[i];
-            else elementA = INT32_MAX;
-        }
-        // elementA > elementB
-        else {
-            ++j;
-            if(j < bTo) elementB = b[j];
-            else elementB = INT32_MAX;
-        }
-    }
+    const size_t aSize = aFrom < aTo ? aTo - aFrom : 0;
+    const size_t bSize = bFrom < bTo ? bTo - bFrom : 0;
+    std::vector<int> list = std::vector<int>(std::min(aSize, bSize));
+    if(list.empty()) return list;
 
+    list.resize(setKernels.sorted_intersection(a.data() + aFrom, aSize, b.data() + bFrom, bSize, list.data()));
     return list;
 }
 
-// returns a sorted vector with all the elements in `a` that are not in `b`. Using the index slices [aFrom,aTo) and [bFrom,bTo).
+// returns a sorted vector with all the elements in `a` that are not in `b`. Assumes unique elements. Using the index slices [aFrom,aTo) and [bFrom,bTo).
 std::vector<int> Graph::sorted_difference_slice(const std::vector<int>& a, size_t aFrom, size_t aTo, const std::vector<int>& b, size_t bFrom, size_t bTo) {
-    std::vector<int> list = std::vector<int>();
-
-    size_t i=aFrom;
-    size_t j=bFrom;
-
-    int elementA = i < aTo ? a[i] : INT32_MAX;
-    int elementB = j < bTo ? b[j] : INT32_MAX;
-
-    while(i < aTo) {
-        if(elementA == elementB) {
-            ++i;
-            ++j;
-            if(i < aTo) elementA = a[i];
-            else elementA = INT32_MAX;
-
-            if(j < bTo) elementB = b[j];
-            else elementB = INT32_MAX;
-        }
-        else if(elementA < elementB) {
-            list.push_back(elementA);
-            ++i;
-            if(i < aTo) elementA = a[i];
-            else elementA = INT32_MAX;
-        }
-        // elementA > elementB
-        else {
-            while(elementA > elementB){
-                ++j;
-                if(j < bTo) elementB = b[j];
-                else {
-                    elementB = INT32_MAX;
-                    break;
-                }
-            }
-        }
-    }
+    const size_t aSize = aFrom < aTo ? aTo - aFrom : 0;
+    const size_t bSize = bFrom < bTo ? bTo - bFrom : 0;
+    std::vector<int> list = std::vector<int>(aSize);
+    if(list.empty()) return list;
 
+    list.resize(setKernels.sorted_difference(a.data() + aFrom, aSize, b.data() + bFrom, bSize, list.data()));
     return list;
 }
 
@@ -6,12 +6,106 @@
 // 2. a std::vector<std::vector<int>> as sorted adjacency list
 #define GRAPH_H_MATRIX_AND_LIST
 
+// if defined (and GRAPH_H_MATRIX_AND_LIST is defined), graphs with n <= 64 store every adjacency row
+// as a single 64-bit word instead of a cache line aligned row. Then edge_has, edge_add, edge_remove and degree
+// are O(1) without loops and neighbors_bits(v) can be used.
+#define GRAPH_H_BITSET_SMALL
+
+// graphs with at most this many vertices enumerate maximal cliques with P and X as bitsets
+// (AND/ANDNOT/popcount on the adjacency rows) instead of sorted vectors
+#define GRAPH_H_BITSET_CLIQUES_MAX_N 4096
+
+// graphs with fewer vertices always enumerate maximal cliques on one thread (starting threads costs more than the cliques)
+#define GRAPH_H_PARALLEL_CLIQUES_MIN_N 256
+
+#include <cstdint>
 #include <functional>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <optional>
 #include <unordered_set>
 
+#include "Bitset.h"
+
+struct MaximalCliquesShared;
+
+// a maximal clique as it is found by Bron-Kerbosch
+#ifndef GRAPH_H_MATRIX_AND_LIST
+typedef std::unordered_set<int> CliqueType;
+#else
+typedef std::vector<int> CliqueType;
+#endif
+// called for every maximal clique. Returns FALSE to stop the enumeration
+typedef std::function<bool(const CliqueType&)> CliqueCallback;
+
+// contiguous range of a CliquePool (vertices of a clique or clique ids of a vertex)
+template <typename T>
+struct CliquePoolRange {
+    const T* first;
+    const T* last;
+
+    const T* begin() const { return first; }
+    const T* end() const { return last; }
+    size_t size() const { return last - first; }
+    const T& operator[](size_t i) const { return first[i]; }
+};
+
+/** maximal cliques in flat arrays (compressed sparse rows): the vertices of all cliques in one buffer plus offsets,
+ * the clique ids of all vertices in one buffer plus offsets and optionally every clique as a bitset.
+ * Filled by Graph::getMaximalCliques(pool, ...). Reusing the pool for the next graph keeps the memory, so no clique is allocated.
+ */
+struct CliquePool {
+    // clique id -> vertices[offsets[id] .. offsets[id+1]) (in the order they were found, like MaximalCliquesInfo.cliqueList)
+    std::vector<int> vertices;
+    std::vector<size_t> offsets = {0};
+
+    // vertex id -> cliqueIds[vertexOffsets[vid] .. vertexOffsets[vid+1]) (sorted clique ids)
+    std::vector<size_t> cliqueIds;
+    std::vector<size_t> vertexOffsets;
+
+    // if TRUE: clique id -> bits[id * words .. (id+1) * words) with the bits of its vertices set
+    bool bitsEnabled = false;
+    size_t words = 0;
+    BitsetVector bits;
+
+    // vertex in at least s+1 cliques. If no such vertex exists, set to -1
+    int vertexInMoreThanSCliques = -1;
+
+    // scratch for counting the cliques per vertex
+    std::vector<unsigned int> vertexCliqueCounts;
+
+    // number of cliques
+    size_t size() const { return this->offsets.size() - 1; }
+    CliquePoolRange<int> clique(size_t id) const { return {this->vertices.data() + this->offsets[id], this->vertices.data() + this->offsets[id+1]}; }
+    CliquePoolRange<size_t> vertex_cliques(int v) const { return {this->cliqueIds.data() + this->vertexOffsets[v], this->cliqueIds.data() + this->vertexOffsets[v+1]}; }
+    // only if bitsEnabled
+    const uint64_t* clique_bits(size_t id) const { return this->bits.data() + id * this->words; }
+
+    // TRUE if vertex v is in the clique with this id
+    bool clique_has(size_t id, int v) const;
+
+    // remove all cliques, keep the memory
+    void clear();
+    // append a clique (the vertex cliques are only built by index)
+    template <typename T> void push(const T& clique) {
+        this->vertices.insert(this->vertices.end(), clique.begin(), clique.end());
+        this->offsets.push_back(this->vertices.size());
+    }
+    // build the clique ids per vertex (and the bitsets) of a graph with n vertices
+    void index(size_t n);
+};
+
+// limits of Graph::getMaximalCliques(pool, budget): the enumeration stops as soon as a maximum is crossed
+struct CliqueBudget {
+    // more than maxCliques maximal cliques: stop (0: no limit)
+    size_t maxCliques = 0;
+    // fewer than minCliques maximal cliques: rejected (only known after the enumeration)
+    size_t minCliques = 0;
+    // a maximal clique with more than maxCliqueSize vertices: stop (0: no limit)
+    size_t maxCliqueSize = 0;
+};
+
 struct MaximalCliquesInfo {
     // if FALSE do not push to cliques
     bool cliqueListEnabled = true;
@@ -24,12 +118,27 @@ struct MaximalCliquesInfo {
 #endif
     cliqueList;
 
-    std::vector<std::unordered_set<int>> cliqueSets = {};
+    // number of maximal cliques found so far = index of the next clique
+    size_t cliqueCount = 0;
 
+    // if FALSE do not store clique indices in vertexCliques, only count them in vertexCliqueCounts (needs s>0)
+    bool vertexCliquesEnabled = true;
     // map of vertex -> overlapping clique indices
     std::vector<std::vector<size_t>> vertexCliques;
+    // map of vertex -> number of overlapping cliques, only if vertexCliquesEnabled=FALSE
+    std::vector<unsigned int> vertexCliqueCounts;
     // vertex in at least s+1 cliques. If no such vertex exists, set to -1
     int vertexInMoreThanSCliques = -1;
+
+    // if set: push the cliques into the pool instead of cliqueList
+    CliquePool* pool = nullptr;
+
+    // if set: called for every clique. If it returns FALSE, callbackStopped is set and the enumeration stops
+    const CliqueCallback* callback = nullptr;
+    bool callbackStopped = false;
+
+    // only set while the cliques are enumerated on several threads: clique counts per vertex and the early stop of all threads
+    MaximalCliquesShared* shared = nullptr;
 };
 
 struct OverlappingEditingOptions {
@@ -94,6 +203,16 @@ struct OverlappingEditingOptions {
     long timeForbiddenCopy = 0;
 
     long timeNoNeighborMerges = 0;
+
+    // if TRUE: keep the maximal cliques in a CliqueIndex that is updated with every edit of the branch and bound
+    // (and rolled back with the undo) instead of finding all maximal cliques again in every branch.
+    // Experimental: with the checker graphs no faster with useForbiddenCliques (41.3s vs 40.8s),
+    // about 6% faster with useFellowsForbidden (380s vs 404s). No driver turns it on
+    bool incrementalCliques = false;
+
+    // if TRUE and useFellowsForbidden=FALSE: find $u$ by counting the maximal cliques of every vertex in its neighborhood.
+    // The counts are cached and only counted again for vertices next to an edit (ignored if incrementalCliques=TRUE)
+    bool localCliqueCounts = false;
 };
 std::string OverlappingEditingOptionsToString(const OverlappingEditingOptions& options);
 
@@ -121,9 +240,18 @@ class Graph {
     int overlappingClusterEditingLowerBound(unsigned int s, int k, OverlappingEditingOptions& options) const;
     std::vector<Graph> overlappingClusterEditingSolutionsBranchAndBound(size_t s, int k, OverlappingEditingOptions& options, unsigned int maxSolutions) const;
 
-    int getVertexInMoreThanSCliques(int s);
-    MaximalCliquesInfo getMaximalCliques(size_t s=0, bool stopAfterOneVertexInMoreThanS=false);
-    DegeneracyAndOrdering getDegeneracyOrdering(int s=0, int k=0) const;
+    int getVertexInMoreThanSCliques(int s, unsigned int threads=1);
+    size_t countMaximalCliquesContaining(int u, size_t cap);
+    bool cliquesAtMostSCertified(size_t s);
+    bool forEachMaximalClique(const CliqueCallback& callback);
+    bool forEachMaximalCliqueContaining(int u, const CliqueCallback& callback);
+    MaximalCliquesInfo getMaximalCliques(size_t s=0, bool stopAfterOneVertexInMoreThanS=false, unsigned int threads=1);
+    void getMaximalCliques(CliquePool& pool, size_t s=0, bool stopAfterOneVertexInMoreThanS=false, unsigned int threads=1);
+    bool getMaximalCliques(CliquePool& pool, const CliqueBudget& budget);
+    void getDegeneracyOrdering(DegeneracyAndOrdering& result, int s=0, int k=0) const;
+#ifdef GRAPH_H_MATRIX_AND_LIST
+    std::vector<std::vector<int>> getMaximalCliquesInduced(const uint64_t* P);
+#endif
 
     std::vector<int> getAnyWalk(int vertex_start, unsigned int path_size_max) const;
     std::vector<Graph> getComponents() const;
@@ -135,6 +263,12 @@ class Graph {
 
     int degree(int v) const;
 
+    bool bits_has() const;
+    uint64_t neighbors_bits(int v) const;
+    const uint64_t* neighbors_row(int v) const;
+    const uint64_t* rows() const;
+    size_t bits_words() const;
+
     int id_get(const int v) const;
     int id_reverse_get(const int v) const;
     bool id_has() const;
@@ -144,7 +278,14 @@ class Graph {
     unsigned int m() const;
 
     static Graph parse_graph6(const std::string& g6);
+    static Graph parse_sparse6(const std::string& s6);
+    void assign_graph6(std::string_view g6);
+    void assign_sparse6(std::string_view s6);
     std::string to_graph6() const;
+    std::string to_sparse6() const;
+    void assign_triangle_bits(int n, const uint8_t* bits);
+    void triangle_bits(uint8_t* bits) const;
+    static size_t triangle_bytes(size_t n);
 
     explicit Graph(int n);
     explicit Graph(const Graph* G);
@@ -176,6 +317,8 @@ class Graph {
     static std::vector<int> sorted_union_unique(const std::vector<int>& a, const std::vector<int>& b);
     static std::vector<int> sorted_intersection_unique(const std::vector<int>& a, const std::vector<int>& b);
     static std::vector<int> sorted_difference(const std::vector<int>& a, const std::vector<int>& b);
+    static size_t sorted_intersection_count(const std::vector<int>& a, const std::vector<int>& b);
+    static bool sorted_intersection_count_at_least(const std::vector<int>& a, const std::vector<int>& b, size_t k);
 
     static std::vector<int> sorted_union_unique_slice(const std::vector<int>& a, size_t aFrom, size_t aTo, const std::vector<int>& b, size_t bFrom, size_t bTo);
     static std::vector<int> sorted_intersection_unique_slice(const std::vector<int>& a, size_t aFrom, size_t aTo, const std::vector<int>& b, size_t bFrom, size_t bTo);
@@ -190,17 +333,7 @@ class Graph {
     const std::unordered_set<int>& neighbors(int v) const;
 #else
     const std::vector<int>& neighbors(int v) const;
-
-    // edges of vertices as adjacency lists: O(deg(v)) enumeration of neighbors.
-    // O(log(deg(v))) for checking if an edge exists.
-    // O(deg(v)) for inserting/removing an edge (shifting elements)
-    // edges[vertex_id] is the set of adjacent vertices of the vertex. vertex_id \in [0, n)
-    std::vector<std::vector<int>> edges;
-
-    // edges of vertices as matrix: O(1) checking if an edge exists.
-    // O(1) for inserting/removing an edge. O(n) for enumerating neighbors.
-    // edges[vertex_id][vertex_id2] is TRUE if the edge exists, otherwise FALSE
-    std::vector<std::vector<bool>> edges_matrix;
+    const std::vector<std::vector<int>>& adjacency_lists() const;
 #endif
 
     // a map of vertex_id [0,H->n()] -> mapped vertex_id [0,G->n()] with H as this = subgraph
@@ -211,8 +344,34 @@ class Graph {
     unsigned int number_vertices;
     unsigned int number_edges;
 
+#ifdef GRAPH_H_MATRIX_AND_LIST
+    // edges of vertices as adjacency lists: O(deg(v)) enumeration of neighbors.
+    // O(log(deg(v))) for checking if an edge exists.
+    // O(deg(v)) for inserting/removing an edge (shifting elements)
+    // edges[vertex_id] is the set of adjacent vertices of the vertex. vertex_id \in [0, n)
+    // the lists are rebuilt from edges_bits in neighbors(v) when the vertex is marked in edges_dirty
+    mutable std::vector<std::vector<int>> edges;
+
+    // edges of vertices as bitset matrix: O(1) checking/inserting/removing an edge. O(n/64) for intersecting neighborhoods.
+    // Row vertex_id is edges_bits[vertex_id * bits_words() ... (vertex_id+1) * bits_words()) and has bit vertex_id2 set if the edge exists.
+    // Rows are single words if bits_has() (n <= 64), otherwise full 64 byte aligned cache lines.
+    // Only written by the edge functions: they mark the changed lists in edges_dirty (read with neighbors_row/rows)
+    BitsetVector edges_bits;
+
+    // bit vertex_id is set if edges[vertex_id] is outdated
+    mutable std::vector<uint64_t> edges_dirty;
+
+    // number of 64-bit words per row of edges_bits
+    size_t bits_stride;
+#endif
+
     // TRUE if ids has been initialized
     bool ids_initialized;
+
+    void assign_empty(int n);
+#ifdef GRAPH_H_MATRIX_AND_LIST
+    void rows_symmetric();
+#endif
 };
 
 template <typename T> std::vector<T> Graph::vector_slice(const std::vector<T>& vec, size_t from, size_t to) {
@@ -271,6 +430,18 @@ void overlappingClusterEditingFindForbiddenInU(Graph* G, size_t s, int k, Overla
     bool& branchingEditsFoundSubgraph, bool& branchingEditsFound, std::vector<EdgeEdit>& branchingEdits
 );
 
+// u and one separating pair of vertices per pair of cliques of u: a forbidden subgraph (vertex ids of G)
+void forbiddenSubgraphFromCliques(Graph* G, size_t s, int uVertex, const std::vector<CliqueType>& cliquesOverlappingU, std::vector<int>& forbiddenVertices);
+
+// the forbidden subgraph of minimalForbiddenGenerate around uVertex and its first (at most s+1) maximal cliques.
+// FALSE if the branching finds one of its own forbidden subgraphs in G (nothing new to print)
+bool minimalForbiddenFromCliques(Graph* G, size_t s, OverlappingEditingOptions& options, int uVertex,
+    const std::vector<CliqueType>& cliquesOverlappingU, std::vector<int>& forbiddenVertices);
+// minimalForbiddenFromCliques for a vertex in more than s maximal cliques of G (cliquesOverlappingU is reused storage).
+// FALSE if there is none or the branching finds it; prefilterDecided is set if cliquesAtMostSCertified decided G without Bron-Kerbosch
+bool findMinimalForbidden(Graph* G, size_t s, OverlappingEditingOptions& options,
+    std::vector<CliqueType>& cliquesOverlappingU, std::vector<int>& forbiddenVertices, bool& prefilterDecided);
+
 void SubsetsOfSizeLoop(size_t n, size_t indicesSize, std::function<bool(size_t n, std::vector<size_t>)> function);
 
 #endif
@@ -0,0 +1,325 @@
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "GraphBinary.h"
+
+void binary_put(uint8_t* out, uint64_t value, size_t bytes) {
+    for(size_t i=0; i<bytes; ++i) out[i] = (value >> (8 * i)) & 0xff;
+}
+
+uint64_t binary_get(const uint8_t* in, size_t bytes) {
+    uint64_t value = 0;
+    for(size_t i=0; i<bytes; ++i) value |= (uint64_t)in[i] << (8 * i);
+    return value;
+}
+
+bool GraphBinaryHeader::indexed() const {
+    return this->flags & GRAPH_BINARY_INDEXED;
+}
+
+size_t GraphBinaryHeader::triangle_bytes() const {
+    return Graph::triangle_bytes(this->n);
+}
+
+size_t GraphBinaryHeader::record_bytes() const {
+    return (this->indexed() ? 8 : 0) + this->triangle_bytes() + this->payloadBytes;
+}
+
+GraphBinaryWriter::GraphBinaryWriter(FILE* file, const GraphBinaryHeader& header)
+    : file(file), header(header), record(header.record_bytes(), 0), G(0)
+{
+    uint8_t bytes[GRAPH_BINARY_HEADER_BYTES];
+    std::memcpy(bytes, "GRB1", 4);
+    binary_put(bytes + 4, header.n, 4);
+    binary_put(bytes + 8, header.payloadBytes, 4);
+    binary_put(bytes + 12, header.flags, 4);
+    if(fwrite(bytes, 1, GRAPH_BINARY_HEADER_BYTES, this->file) != GRAPH_BINARY_HEADER_BYTES) {
+        throw std::runtime_error("could not write the binary graph header");
+    }
+}
+
+void GraphBinaryWriter::write(const Graph& G, uint64_t index, const void* payload) {
+    if(G.n() != this->header.n) {
+        throw std::runtime_error("binary graph stream with n=" + std::to_string(this->header.n) + " got a graph with n=" + std::to_string(G.n()));
+    }
+
+    uint8_t* out = this->record.data();
+    if(this->header.indexed()) {
+        binary_put(out, index, 8);
+        out += 8;
+    }
+    G.triangle_bits(out);
+    out += this->header.triangle_bytes();
+    if(payload) std::memcpy(out, payload, this->header.payloadBytes);
+    else std::fill(out, out + this->header.payloadBytes, 0);
+
+    if(fwrite(this->record.data(), 1, this->record.size(), this->file) != this->record.size()) {
+        throw std::runtime_error("could not write a binary graph record");
+    }
+}
+
+void GraphBinaryWriter::write_graph6(std::string_view g6, uint64_t index, const void* payload) {
+    this->G.assign_graph6(g6);
+    this->write(this->G, index, payload);
+}
+
+GraphBinaryReader::GraphBinaryReader(FILE* file)
+    : file(file), G(0)
+{
+    uint8_t bytes[GRAPH_BINARY_HEADER_BYTES];
+    if(fread(bytes, 1, GRAPH_BINARY_HEADER_BYTES, this->file) != GRAPH_BINARY_HEADER_BYTES || std::memcmp(bytes, "GRB1", 4) != 0) {
+        throw std::runtime_error("not a binary graph stream (GRB1 header missing)");
+    }
+    this->headerValue.n = binary_get(bytes + 4, 4);
+    this->headerValue.payloadBytes = binary_get(bytes + 8, 4);
+    this->headerValue.flags = binary_get(bytes + 12, 4);
+    this->record.assign(this->headerValue.record_bytes(), 0);
+}
+
+const GraphBinaryHeader& GraphBinaryReader::header() const {
+    return this->headerValue;
+}
+
+bool GraphBinaryReader::next() {
+    // a record of 0 bytes (n <= 1, no index, no payload) cannot be told apart from the end of the file
+    if(this->record.empty()) return false;
+
+    const size_t read = fread(this->record.data(), 1, this->record.size(), this->file);
+    if(read == 0) return false;
+    if(read != this->record.size()) throw std::runtime_error("binary graph stream ends inside a record");
+    return true;
+}
+
+void GraphBinaryReader::seek(size_t record) {
+    if(fseeko(this->file, GRAPH_BINARY_HEADER_BYTES + (off_t)(record * this->record.size()), SEEK_SET) != 0) {
+        throw std::runtime_error("could not seek to binary graph record " + std::to_string(record));
+    }
+}
+
+uint64_t GraphBinaryReader::index() const {
+    return this->headerValue.indexed() ? binary_get(this->record.data(), 8) : 0;
+}
+
+const uint8_t* GraphBinaryReader::triangle() const {
+    return this->record.data() + (this->headerValue.indexed() ? 8 : 0);
+}
+
+const uint8_t* GraphBinaryReader::payload() const {
+    return this->triangle() + this->headerValue.triangle_bytes();
+}
+
+void GraphBinaryReader::assign(Graph& G) const {
+    G.assign_triangle_bits(this->headerValue.n, this->triangle());
+}
+
+std::string GraphBinaryReader::to_graph6() const {
+    this->assign(this->G);
+    return this->G.to_graph6();
+}
+
+GraphCompressedWriter::GraphCompressedWriter(FILE* file, uint32_t n, uint32_t blockRecords)
+    : file(file), n(n), blockRecords(std::max(blockRecords, (uint32_t)1)), triangleBytes(Graph::triangle_bytes(n)),
+      records(0), offset(0), previous(triangleBytes, 0), current(triangleBytes, 0), encoded(), G(0)
+{
+    uint8_t bytes[GRAPH_BINARY_HEADER_BYTES];
+    std::memcpy(bytes, "GRZ1", 4);
+    binary_put(bytes + 4, n, 4);
+    binary_put(bytes + 8, this->blockRecords, 4);
+    binary_put(bytes + 12, 0, 4);
+    this->bytes_write(bytes, GRAPH_BINARY_HEADER_BYTES);
+
+    // mask + every byte
+    this->encoded.reserve((this->triangleBytes + 7) / 8 + this->triangleBytes);
+}
+
+void GraphCompressedWriter::write(const Graph& G) {
+    if(G.n() != this->n) {
+        throw std::runtime_error("binary graph stream with n=" + std::to_string(this->n) + " got a graph with n=" + std::to_string(G.n()));
+    }
+
+    // new block: XOR with zeros
+    if(this->records % this->blockRecords == 0) {
+        this->blockOffsets.push_back(this->offset);
+        std::fill(this->previous.begin(), this->previous.end(), 0);
+    }
+    G.triangle_bits(this->current.data());
+
+    // mask of the non-zero bytes of the XOR, then these bytes
+    const size_t maskBytes = (this->triangleBytes + 7) / 8;
+    this->encoded.assign(maskBytes, 0);
+    for(size_t i=0; i<this->triangleBytes; ++i) {
+        const uint8_t diff = this->current[i] ^ this->previous[i];
+        if(diff == 0) continue;
+        this->encoded[i / 8] |= 1 << (i % 8);
+        this->encoded.push_back(diff);
+    }
+    this->bytes_write(this->encoded.data(), this->encoded.size());
+
+    std::swap(this->previous, this->current);
+    ++this->records;
+}
+
+void GraphCompressedWriter::write_graph6(std::string_view g6) {
+    this->G.assign_graph6(g6);
+    this->write(this->G);
+}
+
+void GraphCompressedWriter::finish() {
+    const uint64_t indexOffset = this->offset;
+    uint8_t bytes[16];
+    for(const uint64_t blockOffset : this->blockOffsets) {
+        binary_put(bytes, blockOffset, 8);
+        this->bytes_write(bytes, 8);
+    }
+    binary_put(bytes, this->records, 8);
+    binary_put(bytes + 8, indexOffset, 8);
+    this->bytes_write(bytes, 16);
+}
+
+void GraphCompressedWriter::bytes_write(const uint8_t* bytes, size_t count) {
+    if(fwrite(bytes, 1, count, this->file) != count) throw std::runtime_error("could not write the compressed graph corpus");
+    this->offset += count;
+}
+
+GraphCorpus::GraphCorpus(const std::string& path)
+    : data(nullptr), bytes(0), records(0), G(0),
+      compressed(false), blockRecords(0), blockIndex(nullptr), decoded(), decodedValid(false), decodedRecord(0), decodedNext(nullptr)
+{
+    const int fd = open(path.c_str(), O_RDONLY);
+    struct stat status;
+    if(fd < 0 || fstat(fd, &status) != 0) {
+        if(fd >= 0) close(fd);
+        throw std::runtime_error("could not open the graph corpus " + path);
+    }
+    this->bytes = status.st_size;
+
+    void* mapped = this->bytes > 0 ? mmap(nullptr, this->bytes, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    // the mapping stays valid after closing the file
+    close(fd);
+    if(mapped == MAP_FAILED) throw std::runtime_error("could not mmap the graph corpus " + path);
+    this->data = static_cast<const uint8_t*>(mapped);
+
+    this->compressed = this->bytes >= GRAPH_BINARY_HEADER_BYTES + 16 && std::memcmp(this->data, "GRZ1", 4) == 0;
+    if(!this->compressed && (this->bytes < GRAPH_BINARY_HEADER_BYTES || std::memcmp(this->data, "GRB1", 4) != 0)) {
+        munmap(mapped, this->bytes);
+        throw std::runtime_error("not a binary graph stream (GRB1 or GRZ1 header missing): " + path);
+    }
+    this->headerValue.n = binary_get(this->data + 4, 4);
+
+    if(this->compressed) {
+        // no index and no payload: the header field is the block size
+        this->blockRecords = std::max(binary_get(this->data + 8, 4), (uint64_t)1);
+        this->records = binary_get(this->data + this->bytes - 16, 8);
+        const uint64_t indexOffset = binary_get(this->data + this->bytes - 8, 8);
+        const uint64_t blocks = (this->records + this->blockRecords - 1) / this->blockRecords;
+        if(indexOffset < GRAPH_BINARY_HEADER_BYTES || indexOffset > this->bytes || blocks > this->bytes / 8
+            || indexOffset + 8 * blocks + 16 != this->bytes) {
+            munmap(mapped, this->bytes);
+            throw std::runtime_error("compressed graph corpus without a complete block index: " + path);
+        }
+        this->blockIndex = this->data + indexOffset;
+        this->decoded.assign(this->headerValue.triangle_bytes(), 0);
+        return;
+    }
+
+    this->headerValue.payloadBytes = binary_get(this->data + 8, 4);
+    this->headerValue.flags = binary_get(this->data + 12, 4);
+
+    const size_t recordBytes = this->headerValue.record_bytes();
+    this->records = recordBytes > 0 ? (this->bytes - GRAPH_BINARY_HEADER_BYTES) / recordBytes : 0;
+}
+
+GraphCorpus::~GraphCorpus() {
+    munmap(const_cast<uint8_t*>(this->data), this->bytes);
+}
+
+const GraphBinaryHeader& GraphCorpus::header() const {
+    return this->headerValue;
+}
+
+size_t GraphCorpus::size() const {
+    return this->records;
+}
+
+const uint8_t* GraphCorpus::record(size_t record) const {
+    if(record >= this->records) throw std::runtime_error("graph corpus has no record " + std::to_string(record));
+    return this->data + GRAPH_BINARY_HEADER_BYTES + record * this->headerValue.record_bytes();
+}
+
+uint64_t GraphCorpus::index(size_t record) const {
+    return this->headerValue.indexed() ? binary_get(this->record(record), 8) : record;
+}
+
+const uint8_t* GraphCorpus::triangle(size_t record) const {
+    if(this->compressed) return this->decode(record);
+    return this->record(record) + (this->headerValue.indexed() ? 8 : 0);
+}
+
+// decode the records of the block of `record` up to `record`. Continues at the decoded record if it is before `record` in the same block.
+// Block offsets, masks and XOR bytes are checked against the blocks [header, block index) of the file: a corrupt file is thrown
+const uint8_t* GraphCorpus::decode(size_t record) const {
+    if(record >= this->records) throw std::runtime_error("graph corpus has no record " + std::to_string(record));
+
+    const size_t block = record / this->blockRecords;
+    const uint8_t* blocksBegin = this->data + GRAPH_BINARY_HEADER_BYTES;
+    const uint8_t* blocksEnd = this->blockIndex;
+    if(!this->decodedValid || this->decodedRecord > record || this->decodedRecord / this->blockRecords != block) {
+        const uint64_t blockOffset = binary_get(this->blockIndex + 8 * block, 8);
+        if(blockOffset < GRAPH_BINARY_HEADER_BYTES || blockOffset > (uint64_t)(blocksEnd - this->data)) {
+            throw std::runtime_error("compressed graph corpus: block " + std::to_string(block) + " at offset " + std::to_string(blockOffset)
+                + " outside of the blocks");
+        }
+        std::fill(this->decoded.begin(), this->decoded.end(), 0);
+        this->decodedNext = this->data + blockOffset;
+        this->decodedValid = false;
+    }
+
+    const size_t triangleBytes = this->decoded.size();
+    const size_t maskBytes = (triangleBytes + 7) / 8;
+    size_t next = this->decodedValid ? this->decodedRecord + 1 : block * this->blockRecords;
+    while(next <= record) {
+        const uint8_t* mask = this->decodedNext;
+        const uint8_t* diff = mask + maskBytes;
+        if(mask < blocksBegin || maskBytes > (size_t)(blocksEnd - mask)) {
+            this->decodedValid = false;
+            throw std::runtime_error("compressed graph corpus: record " + std::to_string(next) + " ends after the blocks");
+        }
+        size_t diffBytes = 0;
+        for(size_t i=0; i<maskBytes; ++i) diffBytes += __builtin_popcount(mask[i]);
+        // bits after the last byte of the triangle would write behind `decoded`
+        const unsigned int lastBits = triangleBytes % 8;
+        if(diffBytes > (size_t)(blocksEnd - diff) || (lastBits > 0 && (mask[maskBytes - 1] >> lastBits) != 0)) {
+            this->decodedValid = false;
+            throw std::runtime_error("compressed graph corpus: record " + std::to_string(next) + " has a bad mask");
+        }
+
+        for(size_t i=0; i<maskBytes; ++i) {
+            for(unsigned int bits = mask[i]; bits; bits &= bits - 1) {
+                this->decoded[i * 8 + __builtin_ctz(bits)] ^= *diff++;
+            }
+        }
+        this->decodedNext = diff;
+        this->decodedRecord = next++;
+        this->decodedValid = true;
+    }
+    return this->decoded.data();
+}
+
+const uint8_t* GraphCorpus::payload(size_t record) const {
+    return this->triangle(record) + this->headerValue.triangle_bytes();
+}
+
+void GraphCorpus::assign(size_t record, Graph& G) const {
+    G.assign_triangle_bits(this->headerValue.n, this->triangle(record));
+}
+
+std::string GraphCorpus::to_graph6(size_t record) const {
+    this->assign(record, this->G);
+    return this->G.to_graph6();
+}
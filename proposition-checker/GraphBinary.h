@@ -0,0 +1,176 @@
+#ifndef GRAPH_BINARY_H
+#define GRAPH_BINARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Graph.h"
+
+/*
+Binary graph stream: graphs with the same number of vertices as fixed size records, so a file can be mmapped or seeked.
+All numbers are little endian.
+
+header (GRAPH_BINARY_HEADER_BYTES): "GRB1", uint32 n, uint32 payload bytes per record, uint32 flags
+record:                             [uint64 index if GRAPH_BINARY_INDEXED] packed lower triangle (Graph::triangle_bits) [payload]
+
+Block compressed corpus (see GraphCompressedWriter), only adjacency bits:
+
+header (GRAPH_BINARY_HEADER_BYTES): "GRZ1", uint32 n, uint32 records per block, uint32 flags (0)
+blocks:                             records as XOR with the previous record of the block: mask of the non-zero bytes + these bytes
+block index:                        uint64 file offset per block
+trailer (16 bytes):                 uint64 number of records, uint64 file offset of the block index
+*/
+
+#define GRAPH_BINARY_HEADER_BYTES 16
+// flag: every record starts with a 64-bit index (e.g. the line number in the geng stream)
+#define GRAPH_BINARY_INDEXED 1
+
+struct GraphBinaryHeader {
+    uint32_t n = 0;
+    // bytes after the adjacency bits of every record (e.g. k and timings of a solver), meaning defined by the tool
+    uint32_t payloadBytes = 0;
+    uint32_t flags = 0;
+
+    bool indexed() const;
+    // bytes of the adjacency bits of one record
+    size_t triangle_bytes() const;
+    // bytes of one record
+    size_t record_bytes() const;
+};
+
+/** writes the header and then one record per graph to a file (or pipe) */
+class GraphBinaryWriter {
+  public:
+    GraphBinaryWriter(FILE* file, const GraphBinaryHeader& header);
+
+    // append a graph with header.n vertices. payload has header.payloadBytes bytes (nullptr: zeros)
+    void write(const Graph& G, uint64_t index=0, const void* payload=nullptr);
+    // append the graph of a graph6 string (see Graph::assign_graph6)
+    void write_graph6(std::string_view g6, uint64_t index=0, const void* payload=nullptr);
+
+  private:
+    FILE* file;
+    GraphBinaryHeader header;
+    // the record that is written
+    std::vector<uint8_t> record;
+    // graph for write_graph6 (reused for every record)
+    Graph G;
+};
+
+/** reads the header and then one record per next() from a file (or pipe). seek() only works on files */
+class GraphBinaryReader {
+  public:
+    explicit GraphBinaryReader(FILE* file);
+
+    const GraphBinaryHeader& header() const;
+
+    // read the next record, FALSE at the end of the file
+    bool next();
+    // the next call of next() reads the record with this number
+    void seek(size_t record);
+
+    // current record
+    uint64_t index() const;
+    const uint8_t* triangle() const;
+    const uint8_t* payload() const;
+    void assign(Graph& G) const;
+    std::string to_graph6() const;
+
+  private:
+    FILE* file;
+    GraphBinaryHeader headerValue;
+    std::vector<uint8_t> record;
+    // graph for to_graph6 (reused for every record)
+    mutable Graph G;
+};
+
+/** writes a block compressed corpus (GRZ1). Consecutive graphs of geng differ in a few edges, so every record is stored as the XOR
+ * with the previous record: a mask of the non-zero XOR bytes and these bytes. The first record of a block is XORed with zeros,
+ * so every block can be decoded on its own. finish() writes the block index and the trailer, so pipes work as output.
+ */
+class GraphCompressedWriter {
+  public:
+    GraphCompressedWriter(FILE* file, uint32_t n, uint32_t blockRecords=4096);
+
+    // append a graph with n vertices
+    void write(const Graph& G);
+    // append the graph of a graph6 string (see Graph::assign_graph6)
+    void write_graph6(std::string_view g6);
+    // write the block index and the trailer after the last graph
+    void finish();
+
+  private:
+    FILE* file;
+    uint32_t n;
+    uint32_t blockRecords;
+    size_t triangleBytes;
+
+    uint64_t records;
+    // bytes written
+    uint64_t offset;
+    std::vector<uint64_t> blockOffsets;
+
+    // packed adjacency of the previous and the current record, encoded record
+    std::vector<uint8_t> previous;
+    std::vector<uint8_t> current;
+    std::vector<uint8_t> encoded;
+    // graph for write_graph6 (reused for every record)
+    Graph G;
+
+    void bytes_write(const uint8_t* bytes, size_t count);
+};
+
+/** a binary graph stream file opened with mmap as a corpus of graphs (e.g. the output of geng, built with graphBinary -e -i).
+ * All records have the same size, so record i is at GRAPH_BINARY_HEADER_BYTES + i * record_bytes(): this is the offset index.
+ * Graph #i or a range [a, b) is read without any I/O for the records before it.
+ * Block compressed corpora (GRZ1, graphBinary -e -z) are decoded from the start of the block of graph #i,
+ * reading the records in order only decodes one record per graph. Then triangle() is valid until the next call.
+ */
+class GraphCorpus {
+  public:
+    explicit GraphCorpus(const std::string& path);
+    ~GraphCorpus();
+    GraphCorpus(const GraphCorpus&) = delete;
+    GraphCorpus& operator=(const GraphCorpus&) = delete;
+
+    const GraphBinaryHeader& header() const;
+    // number of records
+    size_t size() const;
+
+    uint64_t index(size_t record) const;
+    const uint8_t* triangle(size_t record) const;
+    const uint8_t* payload(size_t record) const;
+    void assign(size_t record, Graph& G) const;
+    std::string to_graph6(size_t record) const;
+
+  private:
+    const uint8_t* data;
+    size_t bytes;
+    GraphBinaryHeader headerValue;
+    size_t records;
+    // graph for to_graph6 (reused for every record)
+    mutable Graph G;
+
+    // GRZ1: records per block, block offsets
+    bool compressed;
+    uint32_t blockRecords;
+    const uint8_t* blockIndex;
+    // GRZ1: the decoded record, its number (only if decodedValid) and the position of the next record
+    mutable std::vector<uint8_t> decoded;
+    mutable bool decodedValid;
+    mutable size_t decodedRecord;
+    mutable const uint8_t* decodedNext;
+
+    const uint8_t* record(size_t record) const;
+    const uint8_t* decode(size_t record) const;
+};
+
+// write/read a little endian number of `bytes` bytes
+void binary_put(uint8_t* out, uint64_t value, size_t bytes);
+uint64_t binary_get(const uint8_t* in, size_t bytes);
+
+#endif
@@ -0,0 +1,81 @@
+#include "GraphStream.h"
+
+#ifdef GRAPH_H_MATRIX_AND_LIST
+
+Graph6Stream::Graph6Stream(size_t maxEdits)
+    : maxEdits(maxEdits), G(0), index(&G)
+{
+}
+
+Graph& Graph6Stream::graph() {
+    return this->G;
+}
+
+CliqueIndex& Graph6Stream::cliques() {
+    return this->index;
+}
+
+void Graph6Stream::next(const std::string& line) {
+    // different number of vertices (or the first line)
+    if(this->previous.empty() || line.size() != this->previous.size() || line.compare(0, this->headerLength, this->previous, 0, this->headerLength) != 0) {
+        this->rebuild(line);
+        return;
+    }
+
+    // XOR of the 6 adjacency bits per character. Bit 5 of the first character is the first edge
+    this->edits.clear();
+    for(size_t idx=this->headerLength; idx<line.size() && this->edits.size() <= this->maxEdits; ++idx) {
+        // not a graph6 character: assign_graph6 throws
+        if(line[idx] < 63 || line[idx] > 126) {
+            this->rebuild(line);
+            return;
+        }
+        const int diff = (line[idx] - 63) ^ (this->previous[idx] - 63);
+        for(int bit=5; bit>=0; --bit) {
+            // the padding bits of the last character are no edges
+            const size_t position = (idx - this->headerLength) * 6 + (5 - bit);
+            if(((diff >> bit) & 1) && position < this->bitEdges.size()) this->edits.push_back(this->bitEdges[position]);
+        }
+    }
+    if(this->edits.size() > this->maxEdits) {
+        this->rebuild(line);
+        return;
+    }
+
+    for(auto& edit : this->edits) {
+        if(this->G.edge_has(edit.from, edit.to)) {
+            this->G.edge_remove(edit.from, edit.to);
+            this->index.edge_removed(edit.from, edit.to);
+        }
+        else {
+            this->G.edge_add(edit.from, edit.to);
+            this->index.edge_added(edit.from, edit.to);
+        }
+    }
+    this->stats.edits += this->edits.size();
+    ++this->stats.incremental;
+
+    // nothing is rolled back: drop the removed cliques once they outnumber the maximal ones
+    if(this->index.checkpoint() > 4 * this->index.size() + 64) this->index.compact();
+
+    this->previous = line;
+}
+
+void Graph6Stream::rebuild(const std::string& line) {
+    this->G.assign_graph6(line);
+    this->index = CliqueIndex(&this->G);
+    ++this->stats.rebuilt;
+
+    const int n = this->G.n();
+    this->headerLength = line.size() - ((size_t)n * (n - 1) / 2 + 5) / 6;
+    if(this->bitEdges.size() != (size_t)(n * (n - 1) / 2)) {
+        this->bitEdges.clear();
+        for(int i=0; i<n; ++i) {
+            for(int j=0; j<i; ++j) this->bitEdges.push_back({.from = i, .to = j});
+        }
+    }
+
+    this->previous = line;
+}
+
+#endif
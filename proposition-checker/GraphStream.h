@@ -0,0 +1,69 @@
+#ifndef GRAPH_STREAM_H
+#define GRAPH_STREAM_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "Graph.h"
+#include "CliqueIndex.h"
+
+class Graph6Stream;
+
+#ifdef GRAPH_H_MATRIX_AND_LIST
+
+// what Graph6Stream::next did with the lines
+struct Graph6StreamStats {
+    // lines applied as edge edits to the previous graph
+    size_t incremental = 0;
+    // lines parsed from scratch (first line, n changed or too many edits)
+    size_t rebuilt = 0;
+    // edge edits applied in total
+    size_t edits = 0;
+};
+
+/** graph6 lines of a stream (e.g. nauty-geng) read into one persistent graph and its maximal cliques (CliqueIndex).
+ * Consecutive graphs of geng often differ in a few edges: the XOR of the adjacency bits of the previous and the current line
+ * gives these edges, they are applied as edge edits so the cliques are only updated around the edited edges.
+ * If more than maxEdits edges differ or the number of vertices changes, the graph and its cliques are rebuilt.
+ */
+class Graph6Stream {
+  public:
+    explicit Graph6Stream(size_t maxEdits=8);
+    // the clique index points to the member G: a copied or moved stream would update the cliques of the other graph
+    Graph6Stream(const Graph6Stream&) = delete;
+    Graph6Stream& operator=(const Graph6Stream&) = delete;
+    Graph6Stream(Graph6Stream&&) = delete;
+    Graph6Stream& operator=(Graph6Stream&&) = delete;
+
+    // read the next graph6 line. Graph and cliques stay valid until the next line
+    void next(const std::string& line);
+
+    Graph& graph();
+    CliqueIndex& cliques();
+
+    Graph6StreamStats stats;
+
+  private:
+    size_t maxEdits;
+    Graph G;
+    CliqueIndex index;
+    std::string previous;
+    // characters before the adjacency bits (number of vertices)
+    size_t headerLength = 0;
+
+    struct Edge {
+        int from;
+        int to;
+    };
+    // graph6 bit position -> edge (same order as Graph::parse_graph6)
+    std::vector<Edge> bitEdges;
+    // scratch: edges that differ from the previous line
+    std::vector<Edge> edits;
+
+    void rebuild(const std::string& line);
+};
+
+#endif
+
+#endif
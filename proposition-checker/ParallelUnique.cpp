@@ -0,0 +1,114 @@
+#include "ParallelUnique.h"
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <thread>
+
+#include "Queue.h"
+#include "StringSet.h"
+
+ParallelUnique::ParallelUnique(unsigned int shards, bool arrivalOrder, size_t batchLines)
+    : shardCount(shards > 0 ? shards : std::max(1u, std::thread::hardware_concurrency())), arrivalOrder(arrivalOrder),
+      batchLines(std::max(batchLines, (size_t)1)), uniqueLines(0), memoryBytes(0)
+{
+}
+
+size_t ParallelUnique::size() const {
+    return this->uniqueLines;
+}
+
+size_t ParallelUnique::memory() const {
+    return this->memoryBytes;
+}
+
+unsigned int ParallelUnique::shards() const {
+    return this->shardCount;
+}
+
+void ParallelUnique::run(std::istream& input, const std::function<void(const std::string&)>& print) {
+    const unsigned int shards = this->shardCount;
+    std::vector<std::unique_ptr<BlockingQueue<ShardBatch>>> inputs = {};
+    for(unsigned int shard=0; shard<shards; ++shard) inputs.push_back(std::make_unique<BlockingQueue<ShardBatch>>(16));
+    BlockingQueue<ShardBatch> output = BlockingQueue<ShardBatch>(4 * shards + 16);
+    std::vector<StringSet> sets = std::vector<StringSet>(shards);
+
+    // shard: every batch gives one (maybe empty) batch of new lines, the output thread counts them per input batch
+    auto shardWork = [&inputs, &output, &sets](unsigned int shard) {
+        ShardBatch batch;
+        while(inputs[shard]->pop(batch)) {
+            ShardBatch unique;
+            unique.batch = batch.batch;
+            for(auto& [position, line] : batch.lines) {
+                if(sets[shard].insert(line)) unique.lines.emplace_back(position, std::move(line));
+            }
+            output.push(std::move(unique));
+        }
+    };
+
+    auto outputWork = [this, &output, &print, shards]() {
+        // input batch -> shards that finished it and their new lines
+        std::map<uint64_t, std::pair<unsigned int, std::vector<std::pair<uint32_t, std::string>>>> pending = {};
+        uint64_t next = 0;
+        ShardBatch unique;
+        while(output.pop(unique)) {
+            if(!this->arrivalOrder) {
+                for(const auto& [position, line] : unique.lines) print(line);
+                continue;
+            }
+
+            auto& [finished, lines] = pending[unique.batch];
+            ++finished;
+            std::move(unique.lines.begin(), unique.lines.end(), std::back_inserter(lines));
+            for(auto it = pending.find(next); it != pending.end() && it->second.first == shards; it = pending.find(next)) {
+                auto& ready = it->second.second;
+                std::sort(ready.begin(), ready.end(), [](const auto& a, const auto& b) {
+                    return a.first < b.first;
+                });
+                for(const auto& [position, line] : ready) print(line);
+                pending.erase(it);
+                ++next;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers = {};
+    for(unsigned int shard=0; shard<shards; ++shard) workers.emplace_back(shardWork, shard);
+    std::thread outputThread = std::thread(outputWork);
+
+    // read and route the lines by hash
+    std::hash<std::string> hasher;
+    std::vector<ShardBatch> parts = std::vector<ShardBatch>(shards);
+    uint64_t batch = 0;
+    uint32_t position = 0;
+    auto flush = [&]() {
+        for(unsigned int shard=0; shard<shards; ++shard) {
+            parts[shard].batch = batch;
+            inputs[shard]->push(std::move(parts[shard]));
+            parts[shard] = ShardBatch();
+        }
+        ++batch;
+        position = 0;
+    };
+    std::string line;
+    while(std::getline(input, line)) {
+        if(line.empty()) continue;
+        const unsigned int shard = hasher(line) % shards;
+        parts[shard].lines.emplace_back(position++, std::move(line));
+        if(position == this->batchLines) flush();
+    }
+    if(position > 0) flush();
+
+    for(auto& queue : inputs) queue->close();
+    for(auto& thread : workers) thread.join();
+    output.close();
+    outputThread.join();
+
+    this->uniqueLines = 0;
+    this->memoryBytes = 0;
+    for(const auto& set : sets) {
+        this->uniqueLines += set.size();
+        this->memoryBytes += set.memory();
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef PARALLEL_UNIQUE_H
+#define PARALLEL_UNIQUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/** unique lines of a stream on several threads (uniqueStrings -j).
+ * The reading thread cuts the input into batches and sends every line to the shard of its hash, so equal lines always
+ * meet in the same shard. Every shard thread owns a StringSet (no locks on the set) and sends the new lines to the output thread.
+ * In arrival order the output thread waits until all shards finished a batch and prints its new lines by their position,
+ * so the output is the same as with one thread. Unordered, it prints the new lines of every shard as they come.
+ */
+class ParallelUnique {
+  public:
+    // shards = 0: one shard per hardware thread
+    ParallelUnique(unsigned int shards, bool arrivalOrder, size_t batchLines=4096);
+
+    // read all lines of input and call print (on the output thread) once per unique non-empty line
+    void run(std::istream& input, const std::function<void(const std::string&)>& print);
+
+    // unique lines and bytes of the sets of all shards after run()
+    size_t size() const;
+    size_t memory() const;
+    unsigned int shards() const;
+
+  private:
+    // lines of one input batch for one shard, with their position in the batch
+    struct ShardBatch {
+        uint64_t batch = 0;
+        std::vector<std::pair<uint32_t, std::string>> lines;
+    };
+
+    unsigned int shardCount;
+    bool arrivalOrder;
+    size_t batchLines;
+    size_t uniqueLines;
+    size_t memoryBytes;
+};
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef QUEUE_H
+#define QUEUE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// yields of SpscRing::push/pop before they sleep
+#define SPSC_RING_SPINS 64
+
+/** bounded queue between threads: push() waits while it is full, pop() waits while it is empty.
+ * close() after the last push(): pop() returns FALSE once the queue is closed and empty.
+ * Items are batches (e.g. a few thousand lines), so one lock per push/pop is cheap compared to the work per item.
+ */
+template <typename T>
+class BlockingQueue {
+  public:
+    explicit BlockingQueue(size_t capacity)
+        : capacity(capacity)
+    {
+    }
+
+    void push(T&& item) {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->notFull.wait(lock, [this]() { return this->items.size() < this->capacity; });
+        this->items.push_back(std::move(item));
+        this->notEmpty.notify_one();
+    }
+
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->notEmpty.wait(lock, [this]() { return !this->items.empty() || this->closed; });
+        if(this->items.empty()) return false;
+        item = std::move(this->items.front());
+        this->items.pop_front();
+        this->notFull.notify_one();
+        return true;
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->closed = true;
+        this->notEmpty.notify_all();
+    }
+
+  private:
+    size_t capacity;
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::deque<T> items;
+    bool closed = false;
+};
+
+/** bounded ring between one producer thread and one consumer thread without locks.
+ * The producer only writes head, the consumer only writes tail (on their own cache lines). A slot is published by the
+ * release store of head and freed by the release store of tail. push() and pop() yield SPSC_RING_SPINS times while the
+ * ring is full or empty and then sleep on a condition variable, so an idle stage does not take a core.
+ * The mutex is only taken to sleep and to wake a sleeping thread.
+ * close() after the last push(): pop() returns FALSE once the ring is closed and empty.
+ */
+template <typename T>
+class SpscRing {
+  public:
+    explicit SpscRing(size_t capacity)
+        : slots(capacity + 1)
+    {
+    }
+
+    bool try_push(T&& item) {
+        const size_t head = this->head.load(std::memory_order_relaxed);
+        const size_t next = head + 1 == this->slots.size() ? 0 : head + 1;
+        if(next == this->tail.load(std::memory_order_acquire)) return false;
+        this->slots[head] = std::move(item);
+        this->head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& item) {
+        const size_t tail = this->tail.load(std::memory_order_relaxed);
+        if(tail == this->head.load(std::memory_order_acquire)) return false;
+        item = std::move(this->slots[tail]);
+        this->tail.store(tail + 1 == this->slots.size() ? 0 : tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    void push(T&& item) {
+        while(!this->try_push(std::move(item))) {
+            this->wait([this]() { return !this->full(); });
+        }
+        this->wake();
+    }
+
+    bool pop(T& item) {
+        while(!this->try_pop(item)) {
+            // closed after the last push: empty for good (check the ring again, the push may be right before close)
+            if(this->closed.load(std::memory_order_acquire)) return this->try_pop(item);
+            this->wait([this]() { return !this->empty() || this->closed.load(std::memory_order_acquire); });
+        }
+        this->wake();
+        return true;
+    }
+
+    void close() {
+        this->closed.store(true, std::memory_order_release);
+        this->wake();
+    }
+
+  private:
+    std::vector<T> slots;
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+    std::atomic<bool> closed{false};
+    // threads in wait(): push/pop only lock the mutex if one sleeps
+    alignas(64) std::atomic<int> sleeping{0};
+    std::mutex mutex;
+    std::condition_variable changed;
+
+    bool full() const {
+        const size_t head = this->head.load(std::memory_order_acquire);
+        return (head + 1 == this->slots.size() ? 0 : head + 1) == this->tail.load(std::memory_order_acquire);
+    }
+
+    bool empty() const {
+        return this->tail.load(std::memory_order_acquire) == this->head.load(std::memory_order_acquire);
+    }
+
+    // yield until ready, then sleep until ready.
+    // sleeping is raised before ready is checked under the lock and wake() reads it after the change (seq_cst fences on
+    // both sides): either the sleeper sees the change or wake() sees the sleeper and notifies it under the lock
+    template <typename Ready>
+    void wait(const Ready& ready) {
+        for(int spin=0; spin<SPSC_RING_SPINS; ++spin) {
+            if(ready()) return;
+            std::this_thread::yield();
+        }
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->sleeping.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        this->changed.wait(lock, ready);
+        this->sleeping.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // after a push, pop or close: wake the other thread if it sleeps
+    void wake() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(this->sleeping.load(std::memory_order_relaxed) == 0) return;
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->changed.notify_all();
+    }
+};
+
+#endif
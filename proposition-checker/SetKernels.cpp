@@ -0,0 +1,497 @@
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+
+#include <immintrin.h>
+
+#include "SetKernels.h"
+
+// the kernels for one instruction set are compiled with __attribute__((target(...))),
+// so the translation unit itself only needs the baseline flags (-O3).
+#define SET_KERNELS_SSE42 __attribute__((target("sse4.2,popcnt")))
+#define SET_KERNELS_AVX2 __attribute__((target("avx2,popcnt")))
+#define SET_KERNELS_AVX512 __attribute__((target("avx512f,avx512bw,popcnt")))
+
+////////////////////////////////////////////////
+// sorted arrays: shared tails
+
+// scalar merge intersection of a[i..aSize) and b[j..bSize)
+static inline size_t sortedIntersectionTail(const int* a, size_t i, size_t aSize, const int* b, size_t j, size_t bSize, int* result) {
+    size_t count = 0;
+    while(i < aSize && j < bSize) {
+        if(a[i] < b[j]) ++i;
+        else if(a[i] > b[j]) ++j;
+        else {
+            result[count++] = a[i];
+            ++i;
+            ++j;
+        }
+    }
+    return count;
+}
+
+// scalar merge intersection count of a[i..aSize) and b[j..bSize)
+static inline size_t sortedIntersectionCountTail(const int* a, size_t i, size_t aSize, const int* b, size_t j, size_t bSize) {
+    size_t count = 0;
+    while(i < aSize && j < bSize) {
+        const int x = a[i];
+        const int y = b[j];
+        i += x <= y;
+        j += x >= y;
+        count += x == y;
+    }
+    return count;
+}
+
+// scalar merge difference of a[i..aSize) and b[j..bSize).
+// The first `blockSize` elements of a are skipped if their bit in `blockMatches` is set (matched by an earlier block of b)
+static inline size_t sortedDifferenceTail(const int* a, size_t i, size_t aSize, const int* b, size_t j, size_t bSize, int* result,
+    uint32_t blockMatches, size_t blockSize
+) {
+    size_t count = 0;
+    for(size_t k=0; i < aSize; ++i, ++k) {
+        if(k < blockSize && ((blockMatches >> k) & 1)) continue;
+
+        const int x = a[i];
+        while(j < bSize && b[j] < x) ++j;
+        if(j < bSize && b[j] == x) {
+            ++j;
+            continue;
+        }
+        result[count++] = x;
+    }
+    return count;
+}
+
+////////////////////////////////////////////////
+// scalar
+
+static size_t sortedIntersectionScalar(const int* a, size_t aSize, const int* b, size_t bSize, int* result) {
+    return sortedIntersectionTail(a, 0, aSize, b, 0, bSize, result);
+}
+
+static size_t sortedDifferenceScalar(const int* a, size_t aSize, const int* b, size_t bSize, int* result) {
+    return sortedDifferenceTail(a, 0, aSize, b, 0, bSize, result, 0, 0);
+}
+
+static size_t sortedIntersectionCountScalar(const int* a, size_t aSize, const int* b, size_t bSize) {
+    return sortedIntersectionCountTail(a, 0, aSize, b, 0, bSize);
+}
+
+static void bitsetAndScalar(uint64_t* result, const uint64_t* a, const uint64_t* b, size_t words) {
+    for(size_t i=0; i<words; ++i) result[i] = a[i] & b[i];
+}
+
+static void bitsetAndnotScalar(uint64_t* result, const uint64_t* a, const uint64_t* b, size_t words) {
+    for(size_t i=0; i<words; ++i) result[i] = a[i] & ~b[i];
+}
+
+static size_t bitsetCountScalar(const uint64_t* a, size_t words) {
+    size_t count = 0;
+    for(size_t i=0; i<words; ++i) count += __builtin_popcountll(a[i]);
+    return count;
+}
+
+static size_t bitsetAndCountScalar(const uint64_t* a, const uint64_t* b, size_t words) {
+    size_t count = 0;
+    for(size_t i=0; i<words; ++i) count += __builtin_popcountll(a[i] & b[i]);
+    return count;
+}
+
+////////////////////////////////////////////////
+// SSE4.2: blocks of 4x4 elements compared all-against-all with 4 rotations
+// [Lemire et al. 2016 - SIMD Compression and the Intersection of Sorted Integers]
+
+// bit i is set if a[i] equals any element of the block of b
+SET_KERNELS_SSE42 static inline uint32_t sortedBlockMatchesSse42(__m128i va, __m128i vb) {
+    __m128i eq = _mm_cmpeq_epi32(va, vb);
+    eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x39)));
+    eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x4e)));
+    eq = _mm_or_si128(eq, _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, 0x93)));
+    return _mm_movemask_ps(_mm_castsi128_ps(eq));
+}
+
+SET_KERNELS_SSE42 static size_t sortedIntersectionSse42(const int* a, size_t aSize, const int* b, size_t bSize, int* result) {
+    size_t i = 0, j = 0, count = 0;
+    while(i + 4 <= aSize && j + 4 <= bSize) {
+        const __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        const __m128i vb = _mm_loadu_si128((const __m128i*)(b + j));
+        for(uint32_t mask = sortedBlockMatchesSse42(va, vb); mask; mask &= mask - 1) {
+            result[count++] = a[i + __builtin_ctz(mask)];
+        }
+        const int aMax = a[i + 3];
+        const int bMax = b[j + 3];
+        i += aMax <= bMax ? 4 : 0;
+        j += bMax <= aMax ? 4 : 0;
+    }
+    return count + sortedIntersectionTail(a, i, aSize, b, j, bSize, result + count);
+}
+
+SET_KERNELS_SSE42 static size_t sortedIntersectionCountSse42(const int* a, size_t aSize, const int* b, size_t bSize) {
+    size_t i = 0, j = 0, count = 0;
+    while(i + 4 <= aSize && j + 4 <= bSize) {
+        const __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        const __m128i vb = _mm_loadu_si128((const __m128i*)(b + j));
+        count += __builtin_popcount(sortedBlockMatchesSse42(va, vb));
+        const int aMax = a[i + 3];
+        const int bMax = b[j + 3];
+        i += aMax <= bMax ? 4 : 0;
+        j += bMax <= aMax ? 4 : 0;
+    }
+    return count + sortedIntersectionCountTail(a, i, aSize, b, j, bSize);
+}
+
+SET_KERNELS_SSE42 static size_t sortedDifferenceSse42(const int* a, size_t aSize, const int* b, size_t bSize, int* result) {
+    size_t i = 0, j = 0, count = 0;
+    // matches of the current block of a with all blocks of b so far
+    uint32_t matches = 0;
+    while(i + 4 <= aSize && j + 4 <= bSize) {
+        const __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        const __m128i vb = _mm_loadu_si128((const __m128i*)(b + j));
+        matches |= sortedBlockMatchesSse42(va, vb);
+        const int aMax = a[i + 3];
+        const int bMax = b[j + 3];
+        if(aMax <= bMax) {
+            for(uint32_t mask = ~matches & 0xf; mask; mask &= mask - 1) {
+                result[count++] = a[i + __builtin_ctz(mask)];
+            }
+            i += 4;
+            matches = 0;
+        }
+        if(bMax <= aMax) j += 4;
+    }
+    return count + sortedDifferenceTail(a, i, aSize, b, j, bSize, result + count, matches, 4);
+}
+
+SET_KERNELS_SSE42 static void bitsetAndSse42(uint64_t* result, const uint64_t* a, const uint64_t* b, size_t words) {
+    size_t i = 0;
+    for(; i+2 <= words; i += 2) {
+        const __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        const __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        _mm_storeu_si128((__m128i*)(result + i), _mm_and_si128(va, vb));
+    }
+    for(; i < words; ++i) result[i] = a[i] & b[i];
+}
+
+SET_KERNELS_SSE42 static void bitsetAndnotSse42(uint64_t* result, const uint64_t* a, const uint64_t* b, size_t words) {
+    size_t i = 0;
+    for(; i+2 <= words; i += 2) {
+        const __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        const __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        _mm_storeu_si128((__m128i*)(result + i), _mm_andnot_si128(vb, va));
+    }
+    for(; i < words; ++i) result[i] = a[i] & ~b[i];
+}
+
+SET_KERNELS_SSE42 static size_t bitsetCountSse42(const uint64_t* a, size_t words) {
+    size_t count = 0;
+    for(size_t i=0; i<words; ++i) count += _mm_popcnt_u64(a[i]);
+    return count;
+}
+
+SET_KERNELS_SSE42 static size_t bitsetAndCountSse42(const uint64_t* a, const uint64_t* b, size_t words) {
+    size_t count = 0;
+    for(size_t i=0; i<words; ++i) count += _mm_popcnt_u64(a[i] & b[i]);
+    return count;
+}
+
+////////////////////////////////////////////////
+// AVX2: blocks of 8x8 elements compared all-against-all with 8 rotations
+
+// bit i is set if a[i] equals any element of the block of b
+SET_KERNELS_AVX2 static inline uint32_t sortedBlockMatchesAvx2(__m256i va, __m256i vb) {
+    __m256i eq = _mm256_cmpeq_epi32(va, vb);
+    for(int r=1; r<8; ++r) {
+        const __m256i rotation = _mm256_setr_epi32(r & 7, (r+1) & 7, (r+2) & 7, (r+3) & 7, (r+4) & 7, (r+5) & 7, (r+6) & 7, (r+7) & 7);
+        eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(va, _mm256_permutevar8x32_epi32(vb, rotation)));
+    }
+    return _mm256_movemask_ps(_mm256_castsi256_ps(eq));
+}
+
+SET_KERNELS_AVX2 static size_t sortedIntersectionAvx2(const int* a, size_t aSize, const int* b, size_t bSize, int* result) {
+    size_t i = 0, j = 0, count = 0;
+    while(i + 8 <= aSize && j + 8 <= bSize) {
+        const __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        const __m256i vb = _mm256_loadu_si256((const __m256i*)(b + j));
+        for(uint32_t mask = sortedBlockMatchesAvx2(va, vb); mask; mask &= mask - 1) {
+            result[count++] = a[i + __builtin_ctz(mask)];
+        }
+        const int aMax = a[i + 7];
+        const int bMax = b[j + 7];
+        i += aMax <= bMax ? 8 : 0;
+        j += bMax <= aMax ? 8 : 0;
+    }
+    return count + sortedIntersectionTail(a, i, aSize, b, j, bSize, result + count);
+}
+
+SET_KERNELS_AVX2 static size_t sortedIntersectionCountAvx2(const int* a, size_t aSize, const int* b, size_t bSize) {
+    size_t i = 0, j = 0, count = 0;
+    while(i + 8 <= aSize && j + 8 <= bSize) {
+        const __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        const __m256i vb = _mm256_loadu_si256((const __m256i*)(b + j));
+        count += _mm_popcnt_u32(sortedBlockMatchesAvx2(va, vb));
+        const int aMax = a[i + 7];
+        const int bMax = b[j + 7];
+        i += aMax <= bMax ? 8 : 0;
+        j += bMax <= aMax ? 8 : 0;
+    }
+    return count + sortedIntersectionCountTail(a, i, aSize, b, j, bSize);
+}
+
+SET_KERNELS_AVX2 static size_t sortedDifferenceAvx2(const int* a, size_t aSize, const int* b, size_t bSize, int* result) {
+    size_t i = 0, j = 0, count = 0;
+    // matches of the current block of a with all blocks of b so far
+    uint32_t matches = 0;
+    while(i + 8 <= aSize && j + 8 <= bSize) {
+        const __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        const __m256i vb = _mm256_loadu_si256((const __m256i*)(b + j));
+        matches |= sortedBlockMatchesAvx2(va, vb);
+        const int aMax = a[i + 7];
+        const int bMax = b[j + 7];
+        if(aMax <= bMax) {
+            for(uint32_t mask = ~matches & 0xff; mask; mask &= mask - 1) {
+                result[count++] = a[i + __builtin_ctz(mask)];
+            }
+            i += 8;
+            matches = 0;
+        }
+        if(bMax <= aMax) j += 8;
+    }
+    return count + sortedDifferenceTail(a, i, aSize, b, j, bSize, result + count, matches, 8);
+}
+
+// popcount of each byte via a nibble lookup table, summed to 4 64-bit counters
+// [Mula et al. 2018 - Faster Population Counts Using AVX2 Instructions]
+SET_KERNELS_AVX2 static inline __m256i popcount256(__m256i v) {
+    const __m256i lookup = _mm256_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4, 0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+    const __m256i low = _mm256_set1_epi8(0x0f);
+    const __m256i lo = _mm256_and_si256(v, low);
+    const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low);
+    const __m256i bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+    return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+
+SET_KERNELS_AVX2 static inline size_t sum256(__m256i v) {
+    return _mm256_extract_epi64(v, 0) + _mm256_extract_epi64(v, 1) + _mm256_extract_epi64(v, 2) + _mm256_extract_epi64(v, 3);
+}
+
+SET_KERNELS_AVX2 static void bitsetAndAvx2(uint64_t* result, const uint64_t* a, const uint64_t* b, size_t words) {
+    size_t i = 0;
+    for(; i+4 <= words; i += 4) {
+        const __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        const __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        _mm256_storeu_si256((__m256i*)(result + i), _mm256_and_si256(va, vb));
+    }
+    for(; i < words; ++i) result[i] = a[i] & b[i];
+}
+
+SET_KERNELS_AVX2 static void bitsetAndnotAvx2(uint64_t* result, const uint64_t* a, const uint64_t* b, size_t words) {
+    size_t i = 0;
+    for(; i+4 <= words; i += 4) {
+        const __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        const __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        _mm256_storeu_si256((__m256i*)(result + i), _mm256_andnot_si256(vb, va));
+    }
+    for(; i < words; ++i) result[i] = a[i] & ~b[i];
+}
+
+SET_KERNELS_AVX2 static size_t bitsetCountAvx2(const uint64_t* a, size_t words) {
+    size_t i = 0;
+    __m256i sum = _mm256_setzero_si256();
+    for(; i+4 <= words; i += 4) {
+        sum = _mm256_add_epi64(sum, popcount256(_mm256_loadu_si256((const __m256i*)(a + i))));
+    }
+    size_t count = sum256(sum);
+    for(; i < words; ++i) count += _mm_popcnt_u64(a[i]);
+    return count;
+}
+
+SET_KERNELS_AVX2 static size_t bitsetAndCountAvx2(const uint64_t* a, const uint64_t* b, size_t words) {
+    size_t i = 0;
+    __m256i sum = _mm256_setzero_si256();
+    for(; i+4 <= words; i += 4) {
+        const __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        const __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        sum = _mm256_add_epi64(sum, popcount256(_mm256_and_si256(va, vb)));
+    }
+    size_t count = sum256(sum);
+    for(; i < words; ++i) count += _mm_popcnt_u64(a[i] & b[i]);
+    return count;
+}
+
+////////////////////////////////////////////////
+// AVX-512: blocks of 16x16 elements, every element of b broadcast and compared, matches written with compress
+
+// bit i is set if a[i] equals any element of the block of b
+SET_KERNELS_AVX512 static inline uint32_t sortedBlockMatchesAvx512(__m512i va, const int* b) {
+    __mmask16 mask = 0;
+    for(int r=0; r<16; ++r) {
+        mask |= _mm512_cmpeq_epi32_mask(va, _mm512_set1_epi32(b[r]));
+    }
+    return mask;
+}
+
+SET_KERNELS_AVX512 static size_t sortedIntersectionAvx512(const int* a, size_t aSize, const int* b, size_t bSize, int* result) {
+    size_t i = 0, j = 0, count = 0;
+    while(i + 16 <= aSize && j + 16 <= bSize) {
+        const __m512i va = _mm512_loadu_si512((const void*)(a + i));
+        const __mmask16 mask = sortedBlockMatchesAvx512(va, b + j);
+        _mm512_mask_compressstoreu_epi32((void*)(result + count), mask, va);
+        count += _mm_popcnt_u32(mask);
+        const int aMax = a[i + 15];
+        const int bMax = b[j + 15];
+        i += aMax <= bMax ? 16 : 0;
+        j += bMax <= aMax ? 16 : 0;
+    }
+    return count + sortedIntersectionTail(a, i, aSize, b, j, bSize, result + count);
+}
+
+SET_KERNELS_AVX512 static size_t sortedIntersectionCountAvx512(const int* a, size_t aSize, const int* b, size_t bSize) {
+    size_t i = 0, j = 0, count = 0;
+    while(i + 16 <= aSize && j + 16 <= bSize) {
+        const __m512i va = _mm512_loadu_si512((const void*)(a + i));
+        count += _mm_popcnt_u32(sortedBlockMatchesAvx512(va, b + j));
+        const int aMax = a[i + 15];
+        const int bMax = b[j + 15];
+        i += aMax <= bMax ? 16 : 0;
+        j += bMax <= aMax ? 16 : 0;
+    }
+    return count + sortedIntersectionCountTail(a, i, aSize, b, j, bSize);
+}
+
+SET_KERNELS_AVX512 static size_t sortedDifferenceAvx512(const int* a, size_t aSize, const int* b, size_t bSize, int* result) {
+    size_t i = 0, j = 0, count = 0;
+    // matches of the current block of a with all blocks of b so far
+    uint32_t matches = 0;
+    while(i + 16 <= aSize && j + 16 <= bSize) {
+        const __m512i va = _mm512_loadu_si512((const void*)(a + i));
+        matches |= sortedBlockMatchesAvx512(va, b + j);
+        const int aMax = a[i + 15];
+        const int bMax = b[j + 15];
+        if(aMax <= bMax) {
+            const __mmask16 mask = ~matches & 0xffff;
+            _mm512_mask_compressstoreu_epi32((void*)(result + count), mask, va);
+            count += _mm_popcnt_u32(mask);
+            i += 16;
+            matches = 0;
+        }
+        if(bMax <= aMax) j += 16;
+    }
+    return count + sortedDifferenceTail(a, i, aSize, b, j, bSize, result + count, matches, 16);
+}
+
+// byte-wise nibble lookup popcount, summed to 8 64-bit counters
+SET_KERNELS_AVX512 static inline __m512i popcount512(__m512i v) {
+    // popcount of the nibbles 0..15 in every 128-bit lane (bytes 0,1,1,2 | 1,2,2,3 | 1,2,2,3 | 2,3,3,4)
+    const __m512i lookup = _mm512_set4_epi32(0x04030302, 0x03020201, 0x03020201, 0x02010100);
+    const __m512i low = _mm512_set1_epi8(0x0f);
+    const __m512i lo = _mm512_and_si512(v, low);
+    const __m512i hi = _mm512_and_si512(_mm512_srli_epi16(v, 4), low);
+    const __m512i bytes = _mm512_add_epi8(_mm512_shuffle_epi8(lookup, lo), _mm512_shuffle_epi8(lookup, hi));
+    return _mm512_sad_epu8(bytes, _mm512_setzero_si512());
+}
+
+// sum of the 8 64-bit counters. Stored and added instead of _mm512_reduce_add_epi64/_mm512_extracti64x4_epi64:
+// their _mm*_undefined_* operands give -Wuninitialized warnings on GCC 12
+SET_KERNELS_AVX512 static inline size_t reduceAdd512(__m512i v) {
+    alignas(64) uint64_t lanes[8];
+    _mm512_store_si512((void*)lanes, v);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + lanes[4] + lanes[5] + lanes[6] + lanes[7];
+}
+
+SET_KERNELS_AVX512 static void bitsetAndAvx512(uint64_t* result, const uint64_t* a, const uint64_t* b, size_t words) {
+    size_t i = 0;
+    for(; i+8 <= words; i += 8) {
+        const __m512i va = _mm512_loadu_si512((const void*)(a + i));
+        const __m512i vb = _mm512_loadu_si512((const void*)(b + i));
+        _mm512_storeu_si512((void*)(result + i), _mm512_and_si512(va, vb));
+    }
+    for(; i < words; ++i) result[i] = a[i] & b[i];
+}
+
+SET_KERNELS_AVX512 static void bitsetAndnotAvx512(uint64_t* result, const uint64_t* a, const uint64_t* b, size_t words) {
+    size_t i = 0;
+    for(; i+8 <= words; i += 8) {
+        const __m512i va = _mm512_loadu_si512((const void*)(a + i));
+        const __m512i vb = _mm512_loadu_si512((const void*)(b + i));
+        // a & ~b without _mm512_andnot_si512 (same GCC 12 warning), the compiler folds it into one andnot
+        _mm512_storeu_si512((void*)(result + i), _mm512_and_si512(va, _mm512_xor_si512(vb, _mm512_set1_epi64(-1))));
+    }
+    for(; i < words; ++i) result[i] = a[i] & ~b[i];
+}
+
+SET_KERNELS_AVX512 static size_t bitsetCountAvx512(const uint64_t* a, size_t words) {
+    size_t i = 0;
+    __m512i sum = _mm512_setzero_si512();
+    for(; i+8 <= words; i += 8) {
+        sum = _mm512_add_epi64(sum, popcount512(_mm512_loadu_si512((const void*)(a + i))));
+    }
+    size_t count = reduceAdd512(sum);
+    for(; i < words; ++i) count += _mm_popcnt_u64(a[i]);
+    return count;
+}
+
+SET_KERNELS_AVX512 static size_t bitsetAndCountAvx512(const uint64_t* a, const uint64_t* b, size_t words) {
+    size_t i = 0;
+    __m512i sum = _mm512_setzero_si512();
+    for(; i+8 <= words; i += 8) {
+        const __m512i va = _mm512_loadu_si512((const void*)(a + i));
+        const __m512i vb = _mm512_loadu_si512((const void*)(b + i));
+        sum = _mm512_add_epi64(sum, popcount512(_mm512_and_si512(va, vb)));
+    }
+    size_t count = reduceAdd512(sum);
+    for(; i < words; ++i) count += _mm_popcnt_u64(a[i] & b[i]);
+    return count;
+}
+
+////////////////////////////////////////////////
+// selection
+
+SetKernels SetKernelsGet(const char* name) {
+    if(std::strcmp(name, "avx512") == 0) {
+        return {"avx512", sortedIntersectionAvx512, sortedDifferenceAvx512, sortedIntersectionCountAvx512,
+            bitsetAndAvx512, bitsetAndnotAvx512, bitsetCountAvx512, bitsetAndCountAvx512};
+    }
+    if(std::strcmp(name, "avx2") == 0) {
+        return {"avx2", sortedIntersectionAvx2, sortedDifferenceAvx2, sortedIntersectionCountAvx2,
+            bitsetAndAvx2, bitsetAndnotAvx2, bitsetCountAvx2, bitsetAndCountAvx2};
+    }
+    if(std::strcmp(name, "sse4.2") == 0) {
+        return {"sse4.2", sortedIntersectionSse42, sortedDifferenceSse42, sortedIntersectionCountSse42,
+            bitsetAndSse42, bitsetAndnotSse42, bitsetCountSse42, bitsetAndCountSse42};
+    }
+    return {"scalar", sortedIntersectionScalar, sortedDifferenceScalar, sortedIntersectionCountScalar,
+        bitsetAndScalar, bitsetAndnotScalar, bitsetCountScalar, bitsetAndCountScalar};
+}
+
+bool SetKernelsSupported(const char* name) {
+    __builtin_cpu_init();
+    if(std::strcmp(name, "avx512") == 0) {
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("popcnt");
+    }
+    if(std::strcmp(name, "avx2") == 0) {
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+    }
+    if(std::strcmp(name, "sse4.2") == 0) {
+        return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
+    }
+    return std::strcmp(name, "scalar") == 0;
+}
+
+// select the best kernels supported by the CPU (or the ones given in SET_KERNELS)
+static SetKernels SetKernelsDetect() {
+    const char* requested = std::getenv("SET_KERNELS");
+    if(requested != nullptr && SetKernelsSupported(requested)) return SetKernelsGet(requested);
+
+    for(const char* name : {"avx512", "avx2", "sse4.2"}) {
+        if(SetKernelsSupported(name)) return SetKernelsGet(name);
+    }
+    return SetKernelsGet("scalar");
+}
+
+// constant initialized (the initializer is a constant expression), so it is valid before any dynamic initialization:
+// static objects of other translation units that already use the kernels get the scalar kernels until the selection below
+SetKernels setKernels = {"scalar", sortedIntersectionScalar, sortedDifferenceScalar, sortedIntersectionCountScalar,
+    bitsetAndScalar, bitsetAndnotScalar, bitsetCountScalar, bitsetAndCountScalar};
+// the best kernels replace the scalar ones during the dynamic initialization of this file (before main)
+static const bool setKernelsSelected = (setKernels = SetKernelsDetect(), true);
@@ -0,0 +1,42 @@
+#ifndef SET_KERNELS_H
+#define SET_KERNELS_H
+
+// set operation kernels on sorted int arrays (unique elements) and on bitsets (arrays of 64-bit words).
+// Every kernel has a scalar, SSE4.2, AVX2 and AVX-512 implementation. The best implementation supported
+// by the CPU is selected once at startup, so the same binary runs on every machine.
+// The selection can be overwritten with the environment variable SET_KERNELS=scalar|sse4.2|avx2|avx512
+
+#include <cstddef>
+#include <cstdint>
+
+struct SetKernels {
+    // name of the instruction set: "scalar", "sse4.2", "avx2" or "avx512"
+    const char* name;
+
+    // writes a \cap b to result (at least min(aSize, bSize) elements) and returns its size
+    size_t (*sorted_intersection)(const int* a, size_t aSize, const int* b, size_t bSize, int* result);
+    // writes a \setminus b to result (at least aSize elements) and returns its size
+    size_t (*sorted_difference)(const int* a, size_t aSize, const int* b, size_t bSize, int* result);
+    // returns |a \cap b|
+    size_t (*sorted_intersection_count)(const int* a, size_t aSize, const int* b, size_t bSize);
+
+    // result = a \cap b
+    void (*bitset_and)(uint64_t* result, const uint64_t* a, const uint64_t* b, size_t words);
+    // result = a \setminus b
+    void (*bitset_andnot)(uint64_t* result, const uint64_t* a, const uint64_t* b, size_t words);
+    // returns |a|
+    size_t (*bitset_count)(const uint64_t* a, size_t words);
+    // returns |a \cap b|
+    size_t (*bitset_and_count)(const uint64_t* a, const uint64_t* b, size_t words);
+};
+
+// the kernels selected at startup (the scalar kernels during the static initialization of other files)
+extern SetKernels setKernels;
+
+// returns the kernels of the given instruction set name (or the scalar kernels if the name is unknown)
+SetKernels SetKernelsGet(const char* name);
+
+// returns TRUE if the CPU supports the kernels of the given instruction set name
+bool SetKernelsSupported(const char* name);
+
+#endif
@@ -0,0 +1,127 @@
+#include "StringSet.h"
+
+#include <cstring>
+#include <functional>
+
+#define STRING_SET_OFFSET_MASK ((1ull << 48) - 1)
+
+StringSet::StringSet(size_t capacity)
+    : slots(), count(0), arena(), packed()
+{
+    // at most 3/4 of the slots are used
+    size_t slotCount = 16;
+    while(slotCount * 3 < capacity * 4) slotCount *= 2;
+    this->slots.assign(slotCount, 0);
+}
+
+bool StringSet::insert(std::string_view key) {
+    this->pack(key);
+    const uint64_t hash = StringSet::hash(this->packed.data(), this->packed.size());
+    size_t slot = this->find(hash);
+    if(this->slots[slot] != 0) return false;
+
+    if((this->count + 1) * 4 > this->slots.size() * 3) {
+        this->grow();
+        slot = this->find(hash);
+    }
+    const size_t offset = this->arena.size();
+    this->arena.insert(this->arena.end(), this->packed.begin(), this->packed.end());
+    this->slots[slot] = (hash & ~STRING_SET_OFFSET_MASK) | (offset + 1);
+    ++this->count;
+    return true;
+}
+
+bool StringSet::contains(std::string_view key) const {
+    this->pack(key);
+    return this->slots[this->find(StringSet::hash(this->packed.data(), this->packed.size()))] != 0;
+}
+
+size_t StringSet::size() const {
+    return this->count;
+}
+
+size_t StringSet::memory() const {
+    return this->slots.capacity() * sizeof(uint64_t) + this->arena.capacity();
+}
+
+// varint (length << 1 | 8 bits per character), then the characters
+void StringSet::pack(std::string_view key) const {
+    bool sixBits = true;
+    for(const char c : key) {
+        if(c < 63 || c > 126) {
+            sixBits = false;
+            break;
+        }
+    }
+
+    this->packed.clear();
+    for(uint64_t header = (uint64_t)key.size() << 1 | (sixBits ? 0 : 1); ; header >>= 7) {
+        if(header < 128) {
+            this->packed.push_back(header);
+            break;
+        }
+        this->packed.push_back((header & 127) | 128);
+    }
+
+    if(!sixBits) {
+        this->packed.insert(this->packed.end(), key.begin(), key.end());
+        return;
+    }
+    uint32_t value = 0;
+    int bits = 0;
+    for(const char c : key) {
+        value = (value << 6) | (c - 63);
+        bits += 6;
+        if(bits >= 8) {
+            bits -= 8;
+            this->packed.push_back(value >> bits);
+            value &= (1u << bits) - 1;
+        }
+    }
+    if(bits > 0) this->packed.push_back(value << (8 - bits));
+}
+
+uint64_t StringSet::hash(const uint8_t* packed, size_t bytes) {
+    return std::hash<std::string_view>()(std::string_view((const char*)packed, bytes));
+}
+
+size_t StringSet::packed_bytes(size_t offset) const {
+    uint64_t header = 0;
+    size_t headerBytes = 0;
+    for(int shift=0; ; shift += 7) {
+        const uint8_t byte = this->arena[offset + headerBytes++];
+        header |= (uint64_t)(byte & 127) << shift;
+        if(byte < 128) break;
+    }
+    const uint64_t length = header >> 1;
+    return headerBytes + ((header & 1) ? length : (length * 6 + 7) / 8);
+}
+
+size_t StringSet::find(uint64_t hash) const {
+    const size_t mask = this->slots.size() - 1;
+    const uint64_t fingerprint = hash & ~STRING_SET_OFFSET_MASK;
+    for(size_t slot = hash & mask; ; slot = (slot + 1) & mask) {
+        const uint64_t value = this->slots[slot];
+        if(value == 0) return slot;
+        if((value & ~STRING_SET_OFFSET_MASK) != fingerprint) continue;
+
+        const size_t offset = (value & STRING_SET_OFFSET_MASK) - 1;
+        if(this->packed_bytes(offset) == this->packed.size() && std::memcmp(this->arena.data() + offset, this->packed.data(), this->packed.size()) == 0) {
+            return slot;
+        }
+    }
+}
+
+// double the table, the hashes are computed again from the packed strings
+void StringSet::grow() {
+    std::vector<uint64_t> old = std::vector<uint64_t>(this->slots.size() * 2, 0);
+    std::swap(old, this->slots);
+    const size_t mask = this->slots.size() - 1;
+    for(const uint64_t value : old) {
+        if(value == 0) continue;
+        const size_t offset = (value & STRING_SET_OFFSET_MASK) - 1;
+        size_t slot = StringSet::hash(this->arena.data() + offset, this->packed_bytes(offset)) & mask;
+        while(this->slots[slot] != 0) slot = (slot + 1) & mask;
+        this->slots[slot] = value;
+    }
+}
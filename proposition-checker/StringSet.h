@@ -0,0 +1,46 @@
+#ifndef STRING_SET_H
+#define STRING_SET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/** exact set of short strings (e.g. graph6 lines for uniqueStrings) with little memory per string.
+ * The strings are packed one after another in an arena: a varint with the length, then 6 bits per character if all characters
+ * are in the graph6 alphabet (63..126), otherwise 8 bits per character.
+ * The table uses open addressing with linear probing. A slot is 64 bits: 16 bits of the hash as fingerprint and the offset
+ * of the string in the arena, so a lookup only compares strings with the same fingerprint.
+ * graph6 of 13 vertices: 12 bytes in the arena + 8 bytes per slot instead of a std::string in an unordered_set (50+ bytes).
+ */
+class StringSet {
+  public:
+    explicit StringSet(size_t capacity=1024);
+
+    // TRUE if the string was not in the set
+    bool insert(std::string_view key);
+    bool contains(std::string_view key) const;
+
+    // number of strings
+    size_t size() const;
+    // bytes of the table and the arena
+    size_t memory() const;
+
+  private:
+    // fingerprint << 48 | (offset in the arena + 1), 0: empty
+    std::vector<uint64_t> slots;
+    size_t count;
+    std::vector<uint8_t> arena;
+    // scratch: packed key of the last insert/contains
+    mutable std::vector<uint8_t> packed;
+
+    void pack(std::string_view key) const;
+    static uint64_t hash(const uint8_t* packed, size_t bytes);
+    // bytes of the packed string at this offset of the arena
+    size_t packed_bytes(size_t offset) const;
+    // slot of the packed key or the empty slot where it belongs
+    size_t find(uint64_t hash) const;
+    void grow();
+};
+
+#endif
@@ -14,7 +14,9 @@ nauty-geng -c 14 | ./testWithNauty
 #include <algorithm>
 #include <functional>
 #include <cmath>
+#include <memory>
 #include "Graph.h"
+#include "GraphBinary.h"
 
 #define ANNOTATION_UNDEF 0
 #define ANNOTATION_PERMANENT 1
@@ -108,11 +110,11 @@ int forbiddenSubgraphSizeUpperBound() {
 }
 
 // apply reduction rules
-std::vector<std::pair<int,int>> br_reduce(Graph* G, MaximalCliquesInfo& cliqueInfo, piType& pi, std::vector<int> last_edit_vertices) {
+std::vector<std::pair<int,int>> br_reduce(Graph* G, const CliquePool& cliques, piType& pi, std::vector<int> last_edit_vertices) {
     std::vector<std::pair<int,int>> edits_made = {};
 
     // check if there is a vertex in >s maximal cliques
-    if(cliqueInfo.vertexInMoreThanSCliques == -1) {
+    if(cliques.vertexInMoreThanSCliques == -1) {
         pi.no_forbidden = true;
         return edits_made;
     }
@@ -125,7 +127,7 @@ std::vector<std::pair<int,int>> br_reduce(Graph* G, MaximalCliquesInfo& cliqueIn
         bool found = false;
 
         // lambda to receive the indices and call the solver function
-        auto lambda = [G, &cliqueInfo, &found, &pi, &last_edit_vertices](size_t, std::vector<size_t> indices) {
+        auto lambda = [G, &found, &pi, &last_edit_vertices](size_t, std::vector<size_t> indices) {
             // check no vertex = last_edit_vertices
             for(auto v : indices) {
                 for(auto w : last_edit_vertices) {
@@ -164,11 +166,11 @@ std::vector<std::pair<int,int>> br_reduce(Graph* G, MaximalCliquesInfo& cliqueIn
             // create subgraph
             Graph Gprime = G->getSubgraph(chosenVertices);
 
-            // check subgraph contains a vertex
-            auto cliqueInfoPrime = Gprime.getMaximalCliques(s, true);
+            // check subgraph contains a vertex (only counts the cliques, does not store them)
+            auto vertexInMoreThanSCliques = Gprime.getVertexInMoreThanSCliques(s);
 
             // subgraph contains a forbidden subgraph => infeasible
-            if(cliqueInfoPrime.vertexInMoreThanSCliques >= 0) {
+            if(vertexInMoreThanSCliques >= 0) {
                 found = true;
                 return false; // stop looking for subsets
             }
@@ -380,9 +382,19 @@ void G_edit_toggle(Graph* G, std::vector<std::pair<int,int>>& edits) {
     }
 }
 
+// vertex of clique A that is not in clique B. If `notAdjacentTo` is given, the vertex also has to be non-adjacent to it.
+int distinguisherFind(Graph* G, const CliquePool& cliques, size_t idA, size_t idB, int notAdjacentTo=-1) {
+    for(const int v : cliques.clique(idA)) {
+        if(cliques.clique_has(idB, v)) continue;
+        if(notAdjacentTo >= 0 && G->edge_has(v, notAdjacentTo)) continue;
+        return v;
+    }
+    return -1;
+}
+
 // algorithm for finding a k-clique-minimal induced subgraph G[V_F]
-// find V_F in the given startingCliques (=indices of cliques of cliqueInfo.cliqueSets)
-std::vector<int> findForbiddenSubgraphkCliqueMinimal(Graph* G, MaximalCliquesInfo& cliqueInfo, int k, int vInAllCliques, std::vector<size_t> startingCliques) {
+// find V_F in the given startingCliques (=clique ids of cliques)
+std::vector<int> findForbiddenSubgraphkCliqueMinimal(Graph* G, const CliquePool& cliques, int k, int vInAllCliques, std::vector<size_t> startingCliques) {
     /////////////////////////////////////////
     // trivial distinguisher set $S$, of the given startingCliques
     std::unordered_set<int> S(k*(k-1));
@@ -390,16 +402,8 @@ std::vector<int> findForbiddenSubgraphkCliqueMinimal(Graph* G, MaximalCliquesInf
     size_t iterMax = std::min( (size_t)k, startingCliques.size()); // only need to distinguish $k$ cliques
     for(size_t i=0; i<iterMax; ++i) {
         for(size_t j=i+1; j<iterMax; ++j) {
-            auto& cliqueA = cliqueInfo.cliqueSets[ startingCliques[i] ];
-            auto& cliqueB = cliqueInfo.cliqueSets[ startingCliques[j] ];
-
-            auto AwithoutB = Graph::set_difference(cliqueA, cliqueB);
-            auto BwithoutA = Graph::set_difference(cliqueB, cliqueA);
-            
-            int a = *AwithoutB.begin();
-            auto& neighbors = G->neighbors(a);
-            auto potentialB = Graph::set_difference(cliqueB, std::unordered_set<int>(neighbors.begin(), neighbors.end()));
-            int b = *potentialB.begin();
+            int a = distinguisherFind(G, cliques, startingCliques[i], startingCliques[j]);
+            int b = distinguisherFind(G, cliques, startingCliques[j], startingCliques[i], a);
 
             S.insert(a);
             S.insert(b);
@@ -414,14 +418,15 @@ std::vector<int> findForbiddenSubgraphkCliqueMinimal(Graph* G, MaximalCliquesInf
     // calculate maximal cliques in $S$
     auto cliqueInfoPrime = Gprime->getMaximalCliques(s, false);
 
-    // create clique sets
+    // create clique sets (vertices are removed from them below)
+    std::vector<std::unordered_set<int>> C_F = {};
+    C_F.reserve(cliqueInfoPrime.cliqueList.size());
     for(auto& clique : cliqueInfoPrime.cliqueList) {
-        cliqueInfoPrime.cliqueSets.push_back(std::unordered_set<int>(clique.begin(), clique.end()));
+        C_F.push_back(std::unordered_set<int>(clique.begin(), clique.end()));
     }
 
     /////////////////////////////////////////
     // reduce $G' = G[S]$ to a $k$-clique-minimal induced subgraph
-    auto& C_F = cliqueInfoPrime.cliqueSets; // do not need to deepcopy cliqueInfoPrime.cliqueSets
     auto V_F = std::unordered_set<int>(S.size()); // unordered_set for O(1) removal
     for(int v=0; v<Gprime->n_signed(); ++v) V_F.insert(v); // IDs in the subgraph are 0 .. |V(G')|
 
@@ -517,32 +522,33 @@ std::vector<int> findForbiddenSubgraphkCliqueMinimal(Graph* G, MaximalCliquesInf
     return subgraph;
 }
 
-std::vector<int> findForbiddenSubgraph(Graph* G, MaximalCliquesInfo& cliqueInfo) {
+// find a forbidden subgraph around the vertex v in more than s maximal cliques (v < 0: there is none)
+std::vector<int> findForbiddenSubgraph(Graph* G, int v) {
     // no vertex in s+1 maximal cliques
-    if(cliqueInfo.vertexInMoreThanSCliques < 0) return {};
-
-    int v = cliqueInfo.vertexInMoreThanSCliques;
-
-    auto& vertexCliques = cliqueInfo.vertexCliques[v];
+    if(v < 0) return {};
+
+    // only the first s+1 maximal cliques of v are needed: stop enumerating after them
+    CliquePool cliques;
+    cliques.bitsEnabled = true;
+    G->forEachMaximalCliqueContaining(v, [&cliques](const CliqueType& clique) {
+        cliques.push(clique);
+        return cliques.size() < (size_t)s+1;
+    });
+    cliques.index(G->n());
+
+    std::vector<size_t> vertexCliques = {};
+    for(size_t id=0; id<cliques.size(); ++id) vertexCliques.push_back(id);
     
     // s=1: trivial distinguishers = P_3
     if(s == 1) {
-        auto& cliqueA = cliqueInfo.cliqueSets[vertexCliques[0]];
-        auto cliqueB = cliqueInfo.cliqueSets[vertexCliques[1]];
-
-        auto AwithoutB = Graph::set_difference(cliqueA, cliqueB);
-        auto BwithoutA = Graph::set_difference(cliqueB, cliqueA);
-        
-        auto a = *AwithoutB.begin();
-        auto& neighbors = G->neighbors(a);
-        auto potentialB = Graph::set_difference(cliqueB, std::unordered_set<int>(neighbors.begin(), neighbors.end()));
-        int b = *potentialB.begin();
+        int a = distinguisherFind(G, cliques, vertexCliques[0], vertexCliques[1]);
+        int b = distinguisherFind(G, cliques, vertexCliques[1], vertexCliques[0], a);
 
         return {v,a,b};
     }
 
     // otherwise, find a (s+1)-clique-minimal induced subgraph in the cliques of v
-    return findForbiddenSubgraphkCliqueMinimal(G, cliqueInfo, s+1, v, vertexCliques);
+    return findForbiddenSubgraphkCliqueMinimal(G, cliques, s+1, v, vertexCliques);
 }
 
 // compute branching rules
@@ -576,14 +582,13 @@ std::vector<RuleType> br_compute(Graph* G, piType& piOriginal, bool useForbidden
 
     // new block to free cliqueInfo after
     {
-        // get all cliques + create clique sets
-        auto cliqueInfo = G->getMaximalCliques(s, false);
-        for(auto& clique : cliqueInfo.cliqueList) {
-            cliqueInfo.cliqueSets.push_back(std::unordered_set<int>(clique.begin(), clique.end()));
-        }
+        // get all cliques into a flat pool (no allocation per clique). Local: br_compute is recursive
+        CliquePool cliques;
+        cliques.bitsEnabled = true;
+        G->getMaximalCliques(cliques, s, false);
         
         // apply reduction rules
-        edge_edits = br_reduce(G, cliqueInfo, pi, last_edit_vertices);
+        edge_edits = br_reduce(G, cliques, pi, last_edit_vertices);
 
         // infeasible: found forbidden subgraph where no edit is possible = all pairs of vertices are fixed => no children branch can fix this
         if(pi.infeasible) {
@@ -615,16 +620,14 @@ std::vector<RuleType> br_compute(Graph* G, piType& piOriginal, bool useForbidden
             // check only pairs on a forbidden subgraph
             else {
                 // find forbidden subgraph
-                // verticesToIteratePairsOn = findForbiddenSubgraph(G, cliqueInfo);
+                // verticesToIteratePairsOn = findForbiddenSubgraph(G, cliques.vertexInMoreThanSCliques);
 
                 // find all forbidden subgraphs = all cliques of vertices in >s maximal cliques
                 std::unordered_set<int> V_F(G->n());
                 for(int v=0; v<G->n_signed(); ++v) {
-                    auto& vertexCliques = cliqueInfo.vertexCliques[v];
                     V_F.insert(v);
-                    for(size_t index=0; index<vertexCliques.size(); ++index) {
-                        auto& clique = cliqueInfo.cliqueSets[ vertexCliques[index] ];
-                        for(auto w : clique) V_F.insert(w);
+                    for(const size_t id : cliques.vertex_cliques(v)) {
+                        for(auto w : cliques.clique(id)) V_F.insert(w);
                     }
                 }
                 verticesToIteratePairsOn = std::vector<int>(V_F.begin(), V_F.end());
@@ -633,7 +636,7 @@ std::vector<RuleType> br_compute(Graph* G, piType& piOriginal, bool useForbidden
                 // repeatedly find a forbidden subgraph and remove it from the graph = find all pairs of forbidden subgraphs
                 auto Gprime = G->getSubgraph(V_F);
                 while(true) {
-                    auto forbidden = findForbiddenSubgraph(Gprime, cliqueInfo);
+                    auto forbidden = findForbiddenSubgraph(Gprime, Gprime->getVertexInMoreThanSCliques(s));
                     if(forbidden.empty()) break;
 
 
@@ -802,9 +805,12 @@ std::vector<RuleType> br_compute(Graph* G, piType& piOriginal, bool useForbidden
     return B;
 }
 
-void branchingAutomated(int graphsCount, std::string line, bool useForbiddenSubgraphBrCompute) {
-    Graph GraphValue = Graph::parse_graph6(line);
+// G is the graph number graphsCount. line is its graph6 (empty: G came from a corpus, then graph6 is only formatted for the output)
+void branchingAutomated(int graphsCount, Graph& GraphValue, const std::string& line, bool useForbiddenSubgraphBrCompute) {
     Graph* G = &GraphValue;
+    const auto graph6 = [G, &line]() {
+        return line.empty() ? G->to_graph6() : line;
+    };
     
     // pi: UNDEF for every pair of vertices
     auto pi = piType();
@@ -821,11 +827,11 @@ void branchingAutomated(int graphsCount, std::string line, bool useForbiddenSubg
 
     // infeasible: error
     if(B.empty()) {
-        throw std::runtime_error("Algorithm returned infeasible for the graph "+line+" - but an infeasible instance does not exist.");
+        throw std::runtime_error("Algorithm returned infeasible for the graph "+graph6()+" - but an infeasible instance does not exist.");
     }
     // trivial instance
     if(B.size()==1 && B[0].empty()) {
-        std::cout << __FILE__<<":"<<__LINE__<<" graph "<<graphsCount<<": "<<line
+        std::cout << __FILE__<<":"<<__LINE__<<" graph "<<graphsCount<<": "<<graph6()
             <<" trvial instance (no forbidden subgraph)"
             <<"\n";
         return;
@@ -836,7 +842,7 @@ void branchingAutomated(int graphsCount, std::string line, bool useForbiddenSubg
 
     branchingNumberWorstCase = std::max(branchingNumberWorstCase, br);
 
-    std::cout << __FILE__<<":"<<__LINE__<<" graph "<<graphsCount<<": "<<line
+    std::cout << __FILE__<<":"<<__LINE__<<" graph "<<graphsCount<<": "<<graph6()
         <<" br="<<br
         <<" worstCase="<<branchingNumberWorstCase
         <<"\n";
@@ -905,6 +911,10 @@ int main(int argc, char* argv[]) {
 
     int workers = 1;
     long skipUntilNumber = 0;
+    // stop before this graph (0: no limit)
+    long lastNumber = 0;
+    // binary graph corpus (graphBinary -e) instead of graph6 lines from stdin
+    std::string corpusPath = "";
     bool useForbiddenSubgraphProposition = false;
 
     // parse options
@@ -923,6 +933,14 @@ int main(int argc, char* argv[]) {
         else if(option == "-k" && i+1 < argc) {
             skipUntilNumber = std::stol(argv[++i]);
         }
+        // l: stop before this graph
+        else if(option == "-l" && i+1 < argc) {
+            lastNumber = std::stol(argv[++i]);
+        }
+        // f: read the graphs from a corpus file: -k jumps to the graph without reading the graphs before it
+        else if(option == "-f" && i+1 < argc) {
+            corpusPath = argv[++i];
+        }
         // u: use proposition algorithm
         else if(option == "-u") {
             std::cout << "Using proposition algorithm.\n\n";
@@ -943,6 +961,9 @@ int main(int argc, char* argv[]) {
     }
     if(workers < 1) workers = 1;
 
+    // corpus: opened before the workers are forked, they decode the records of the shared mapping themselves
+    std::unique_ptr<GraphCorpus> corpus = corpusPath.empty() ? nullptr : std::make_unique<GraphCorpus>(corpusPath);
+
     // create pipes
     std::vector<int[2]> pipes(workers);
     for(int i=0;i<workers;i++) {
@@ -973,22 +994,30 @@ int main(int argc, char* argv[]) {
             char buffer[4096];
 
             // run actual program
+            // reused for every line: no allocation per graph
+            Graph GraphValue = Graph(0);
             while(fgets(buffer, sizeof(buffer), stream)) {
                 std::string msg(buffer);
                 if(msg.empty()) continue;
 
-                // split at first space
+                // split at first space. Corpus: only the graph number, the graph is decoded straight from its record
                 size_t pos = msg.find(' ');
-                if(pos == std::string::npos) continue;
+                if(pos == std::string::npos && !corpus) continue;
 
                 int graphsCount = std::stoi(msg.substr(0, pos));
-                std::string line = msg.substr(pos + 1);
+                std::string line = "";
+                if(corpus) {
+                    corpus->assign(graphsCount - 1, GraphValue);
+                } else {
+                    line = msg.substr(pos + 1);
 
-                // remove trailing newline
-                if(!line.empty() && line.back() == '\n')
-                    line.pop_back();
+                    // remove trailing newline
+                    if(!line.empty() && line.back() == '\n')
+                        line.pop_back();
+                    GraphValue.assign_graph6(line);
+                }
 
-                branchingAutomated(graphsCount, line, useForbiddenSubgraphProposition);
+                branchingAutomated(graphsCount, GraphValue, line, useForbiddenSubgraphProposition);
             }
 
             std::cout << "worker id="<<w<<" finished: branchingNumberWorstCase="<< branchingNumberWorstCase<<"\n";
@@ -1010,16 +1039,24 @@ int main(int argc, char* argv[]) {
         std::cout << "SKIPPING GRAPHS UNTIL graphCount="<<skipUntilNumber<<"\n";
     }
 
-    while (std::getline(std::cin, line)) {
-        if(line.empty()) continue;
+    // corpus: start directly at graph skipUntilNumber
+    if(corpus && skipUntil) {
+        graphsCount = skipUntilNumber - 1;
+        skipUntil = false;
+    }
+
+    while (corpus ? graphsCount < (long)corpus->size() : (bool)std::getline(std::cin, line)) {
+        if(!corpus && line.empty()) continue;
 
         ++graphsCount;
+        if(lastNumber > 0 && graphsCount >= lastNumber) break;
         if(skipUntil) {
             if(graphsCount >= skipUntilNumber) skipUntil = false;
             else continue;
         }
 
-        std::string toSend = std::to_string(graphsCount) + " " + line + "\n";
+        // corpus: the worker decodes record graphsCount-1 itself
+        std::string toSend = corpus ? std::to_string(graphsCount) + "\n" : std::to_string(graphsCount) + " " + line + "\n";
 
         if( write(
             pipes[currentWorker][1],
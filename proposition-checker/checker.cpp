@@ -3,6 +3,9 @@ Checks a proposition algorithm vs. a base algorithm.
 
 Run using nauty geng
 nauty-geng -c 14 | ./checker
+
+or on a corpus (nauty-geng -c 10 | ./out/graphBinary -e -i > graphs10.bin), starting at graph 1996:
+./checker -f graphs10.bin -k 1996
 */
 
 #include <iostream>
@@ -10,13 +13,38 @@ nauty-geng -c 14 | ./checker
 #include <vector>
 #include <cstdlib>
 #include <algorithm>
+#include <memory>
 #include "Graph.h"
+#include "GraphBinary.h"
 
-int main() {
+int main(int argc, char* argv[]) {
     // std::ios::sync_with_stdio(false);
     // std::cin.tie(nullptr);
 
     std::string line;
+    // first graph and the graph to stop before (0: no limit)
+    long skipUntilNumber = 0;
+    long lastNumber = 0;
+    // binary graph corpus (graphBinary -e) instead of graph6 lines from stdin
+    std::string corpusPath = "";
+
+    // parse options
+    for(int i=1; i<argc; ++i) {
+        std::string option = argv[i];
+
+        // k: skip until this graph
+        if(option == "-k" && i+1 < argc) {
+            skipUntilNumber = std::stol(argv[++i]);
+        }
+        // l: stop before this graph
+        else if(option == "-l" && i+1 < argc) {
+            lastNumber = std::stol(argv[++i]);
+        }
+        // f: read the graphs from a corpus file: -k jumps to the graph without reading the graphs before it
+        else if(option == "-f" && i+1 < argc) {
+            corpusPath = argv[++i];
+        }
+    }
 
     // even if every non-isomorphic graph works, the "random" selection of forbidden subgraph doesn't guarantee it will always work
 
@@ -36,37 +64,35 @@ int main() {
 
     long graphsCount = 0;
     bool foundGraph = false;
-    while (std::getline(std::cin, line)) {
-        if (line.empty()) continue;
+    // reused for every line: no allocation per graph
+    Graph G = Graph(0);
+
+    // corpus: start directly at graph skipUntilNumber
+    std::unique_ptr<GraphCorpus> corpus = corpusPath.empty() ? nullptr : std::make_unique<GraphCorpus>(corpusPath);
+    if(corpus && skipUntilNumber > 0) graphsCount = skipUntilNumber - 1;
+
+    while (corpus ? graphsCount < (long)corpus->size() : (bool)std::getline(std::cin, line)) {
+        if (!corpus && line.empty()) continue;
         ++graphsCount;
+        if(lastNumber > 0 && graphsCount >= lastNumber) break;
+        if(graphsCount < skipUntilNumber) continue;
         /*if(graphsCount > 1000) {
             std::cout << "Stopping after 1000 graphs for debugging\n";
             break;
         }*/
 
-        std::cout << "########### New graph "<<graphsCount<<": "<<line<<"\n";
-        Graph G = Graph::parse_graph6(line);
-        // n=9, graphCount=261080
-
-        // skip until graph number
-        if(G.n()==10 && graphsCount < 1996 && optionsProposition.isolateProposition) {
-            std::cout << "Skipping graph: already did it\n";
-            continue;
+        if(corpus) {
+            // decoded straight from the record, graph6 only for the output
+            corpus->assign(graphsCount - 1, G);
+            line = G.to_graph6();
         }
-        // critical cliques skip
-        /*if(G.n()==10 && graphsCount < 5536519 && optionsProposition.forbidCriticalCliques && !optionsProposition.useFellowsForbidden) {
-            std::cout << "Skipping graph: already did it\n";
-            continue;
-        }*/
-        if(G.n()==14 && graphsCount < 0 && optionsProposition.forbidCriticalCliques && !optionsProposition.useFellowsForbidden) {
-            std::cout << "Skipping graph: already did it\n";
-            continue;
-        }
-        // fellows forbidden skip
-        if(G.n()==10 && graphsCount < 50 && optionsProposition.useFellowsForbidden) {
-            std::cout << "Skipping graph: already did it\n";
-            continue;
+        std::cout << "########### New graph "<<graphsCount<<": "<<line<<"\n";
+        // sparse6 lines (e.g. large sparse networks) start with ':'
+        if(!corpus) {
+            if(line[0] == ':') G.assign_sparse6(line);
+            else G.assign_graph6(line);
         }
+        // n=9, graphCount=261080
         // skip until specific graph
         /*if(G.n()==10 && !foundGraph) {
             if(line != "I????B_vo") {
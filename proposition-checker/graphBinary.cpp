@@ -0,0 +1,108 @@
+/*
+Converts graph6 lines to binary graph records and back (see GraphBinary.h).
+
+nauty-geng -c 9 | ./out/graphBinary -e -i > graphs9.bin
+./out/graphBinary -d < graphs9.bin | nauty-labelg
+
+block compressed (XOR of consecutive graphs), decoded from the file:
+nauty-geng -c 9 | ./out/graphBinary -e -z > graphs9.grz
+./out/graphBinary -d -f graphs9.grz
+*/
+
+#include <iostream>
+#include <string>
+#include <memory>
+#include <cstdio>
+#include "Graph.h"
+#include "GraphBinary.h"
+
+int main(int argc, char* argv[]) {
+    bool decode = false;
+    bool compressed = false;
+    uint32_t blockRecords = 4096;
+    std::string corpusPath = "";
+    GraphBinaryHeader header = GraphBinaryHeader();
+
+    // parse options
+    for(int i=1; i<argc; ++i) {
+        std::string option = argv[i];
+
+        // e: graph6 lines -> binary records
+        if(option == "-e") {
+            decode = false;
+        }
+        // d: binary records -> graph6 lines
+        else if(option == "-d") {
+            decode = true;
+        }
+        // i: store the line number as index of every record
+        else if(option == "-i") {
+            header.flags |= GRAPH_BINARY_INDEXED;
+        }
+        // p: bytes of payload per record (zeros)
+        else if(option == "-p" && i+1 < argc) {
+            header.payloadBytes = std::stoi(argv[++i]);
+        }
+        // z: block compressed corpus (no index, no payload)
+        else if(option == "-z") {
+            compressed = true;
+        }
+        // b: records per block of the compressed corpus
+        else if(option == "-b" && i+1 < argc) {
+            blockRecords = std::stoi(argv[++i]);
+        }
+        // f: decode this corpus file (binary or compressed) instead of stdin
+        else if(option == "-f" && i+1 < argc) {
+            corpusPath = argv[++i];
+        }
+    }
+
+    // a corrupt corpus or graphs with different n: stdout is the graph stream, the error goes to stderr
+    try {
+        if(decode && !corpusPath.empty()) {
+            GraphCorpus corpus = GraphCorpus(corpusPath);
+            for(size_t record=0; record<corpus.size(); ++record) {
+                std::string g6 = corpus.to_graph6(record);
+                g6.push_back('\n');
+                fwrite(g6.data(), 1, g6.size(), stdout);
+            }
+            return 0;
+        }
+        if(decode) {
+            GraphBinaryReader reader = GraphBinaryReader(stdin);
+            while(reader.next()) {
+                std::string g6 = reader.to_graph6();
+                g6.push_back('\n');
+                fwrite(g6.data(), 1, g6.size(), stdout);
+            }
+            return 0;
+        }
+
+        // the header needs n: created with the first line
+        std::unique_ptr<GraphBinaryWriter> writer = nullptr;
+        std::unique_ptr<GraphCompressedWriter> compressedWriter = nullptr;
+        std::string line;
+        uint64_t lineNumber = 0;
+        Graph G = Graph(0);
+        while (std::getline(std::cin, line)) {
+            if (line.empty()) continue;
+            G.assign_graph6(line);
+            if(compressed) {
+                if(!compressedWriter) compressedWriter = std::make_unique<GraphCompressedWriter>(stdout, G.n(), blockRecords);
+                compressedWriter->write(G);
+                continue;
+            }
+            if(!writer) {
+                header.n = G.n();
+                writer = std::make_unique<GraphBinaryWriter>(stdout, header);
+            }
+            writer->write(G, lineNumber++);
+        }
+        if(compressedWriter) compressedWriter->finish();
+    }
+    catch(const std::exception& e) {
+        std::cerr << "graphBinary: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,65 @@
+/*
+Generates the minimal forbidden subgraphs in one process instead of
+nauty-geng -q -c 9 | ./out/minimalForbiddenGenerate | nauty-labelg -q | ./out/uniqueStrings -i -q
+
+nauty-geng -q -c 9 | ./out/minimalForbiddenPipeline -q
+./out/minimalForbiddenPipeline -q -f graphs9.grz
+
+A reader thread, worker threads and the main thread connected by lock-free rings (see ForbiddenPipeline.h).
+The output is the same as ./out/minimalForbiddenGenerate -u for any number of threads.
+
+Usage:
+minimalForbiddenPipeline [-j threads] [-f corpus] [-q]
+
+-j: worker threads (default: one per hardware thread minus the reader and the output thread, at least one)
+-f: read a binary or compressed corpus (graphBinary -e [-z]) instead of graph6 lines from stdin
+-q: print the outputs in quotes and a comma before the new line (like uniqueStrings -q)
+*/
+
+#include <iostream>
+#include <string>
+#include <cstdio>
+#include "GraphBinary.h"
+#include "ForbiddenPipeline.h"
+
+// bytes of output collected before a write
+#define PIPELINE_OUTPUT_BYTES (1 << 16)
+
+int main(int argc, char* argv[]) {
+    const size_t s = 3;
+    unsigned int threads = 0;
+    std::string corpusPath = "";
+    bool printWithQuotes = false;
+
+    // parse options
+    for(int i=1; i<argc; ++i) {
+        std::string option = argv[i];
+        if(option == "-j" && i+1 < argc) threads = std::stoi(argv[++i]);
+        if(option == "-f" && i+1 < argc) corpusPath = argv[++i];
+        if(option == "-q") printWithQuotes = true;
+    }
+
+    std::string out = "";
+    auto print = [&out, printWithQuotes](const std::string& graph6) {
+        if(printWithQuotes) out += "\"" + graph6 + "\",\n";
+        else out += graph6 + "\n";
+        if(out.size() < PIPELINE_OUTPUT_BYTES) return;
+        fwrite(out.data(), 1, out.size(), stdout);
+        out.clear();
+    };
+
+    ForbiddenPipeline pipeline = ForbiddenPipeline(s, threads);
+    if(!corpusPath.empty()) {
+        GraphCorpus corpus = GraphCorpus(corpusPath);
+        pipeline.run(corpus, print);
+    }
+    else {
+        pipeline.run(std::cin, print);
+    }
+    fwrite(out.data(), 1, out.size(), stdout);
+
+    // stdout is the graph stream: report on stderr
+    std::cerr << pipeline.graphs() << " graphs ("<<pipeline.prefilterDecided()<<" decided by the prefilter), "<<pipeline.forbiddenFound()
+        <<" forbidden subgraphs, "<<pipeline.size()<<" unique on "<<pipeline.threads()<<" worker threads\n";
+    return 0;
+}
@@ -3,7 +3,20 @@
 #include <vector>
 #include <cstdlib>
 #include <algorithm>
+#include <random>
+#include <unistd.h>
 #include "Graph.h"
+#include "CliqueIndex.h"
+#include "GraphStream.h"
+#include "GraphBinary.h"
+#include "Canonical.h"
+#include "StringSet.h"
+#include "ExternalUnique.h"
+#include "ParallelUnique.h"
+#include "Queue.h"
+#include "ForbiddenPipeline.h"
+#include <thread>
+#include <sstream>
 
 #ifndef DEBUG
 #define DEBUG
@@ -35,9 +48,10 @@ void testGraph() {
     }*/
 
     std::cout << "Parsing graph success with " << G.n() << " vertices and " << G.m() << " edges \n";
-    std::cout << "Edges"<<Graph::vector_tostring(G.edges)<<"\n";
+    std::cout << "Edges"<<Graph::vector_tostring(G.adjacency_lists())<<"\n";
 
-    auto ordering = G.getDegeneracyOrdering();
+    DegeneracyAndOrdering ordering;
+    G.getDegeneracyOrdering(ordering);
 
     std::cout << "Degeneracy: " << ordering.degeneracy << "\n";
     std::cout << "Ordering: "<<Graph::vector_tostring(ordering.ordering)<<"\n";
@@ -374,9 +388,1366 @@ void testForbiddenSizeRemovingTwoRandomEdgesOfTrianglesLowerBound(){
     }
 }
 
-int main() {
+// the 64-bit row graph (n <= 64) has to behave exactly like the matrix + list graph (n > 64)
+int test_graph_bits() {
+    int failures = 0;
+    std::mt19937 random(1);
+
+    // same edits on both graphs, vertex 64 of B stays isolated
+    Graph A(64);
+    Graph B(65);
+    if(!A.bits_has() || B.bits_has()) {
+        ++failures;
+        std::cout << "########## Test failed - graph bits: bits_has() for n=64 / n=65 ##########\n";
+    }
+
+    for(int i=0; i<5000; ++i) {
+        int v = random() % 64;
+        int w = random() % 64;
+        if(v == w) continue;
+
+        if(A.edge_has(v,w)) {
+            A.edge_remove(v,w);
+            B.edge_remove(v,w);
+        } else {
+            A.edge_add(v,w);
+            B.edge_add(v,w);
+        }
+
+        // check only some of the time: the lists should be rebuilt after multiple edits
+        if(i % 97 != 0) continue;
+        Graph Copy(&A);
+        for(int x=0; x<64; ++x) {
+            if(A.neighbors(x) != B.neighbors(x) || Copy.neighbors(x) != B.neighbors(x)
+                || A.degree(x) != B.degree(x) || A.neighbors_bits(x) != B.neighbors_bits(x)) {
+                ++failures;
+                std::cout << "########## Test failed - graph bits: neighbors of "<<x<<" "<<Graph::vector_tostring(A.neighbors(x))
+                    <<" != "<<Graph::vector_tostring(B.neighbors(x))<<" ##########\n";
+                return failures;
+            }
+        }
+    }
+    // graph6 only supports n <= 62
+    std::vector<int> vertices = {};
+    for(int v=0; v<62; ++v) vertices.push_back(v);
+    Graph C = A.getSubgraph(vertices);
+    if(A.m() != B.m() || Graph::parse_graph6(C.to_graph6()).adjacency_lists() != C.adjacency_lists()) {
+        ++failures;
+        std::cout << "########## Test failed - graph bits: m="<<A.m()<<" != "<<B.m()<<" or graph6 ##########\n";
+    }
+
+    // multi-word rows (n > 64): edits in every word of the rows vs an adjacency matrix
+    const int n = 200;
+    Graph M(n);
+    std::vector<std::vector<bool>> matrix = std::vector<std::vector<bool>>(n, std::vector<bool>(n, false));
+    size_t edges = 0;
+    for(int i=0; i<20000 && failures == 0; ++i) {
+        const int v = random() % n;
+        const int w = random() % n;
+        if(v == w) continue;
+
+        if(matrix[v][w]) {
+            M.edge_remove(v, w);
+            --edges;
+        } else {
+            M.edge_add(v, w);
+            ++edges;
+        }
+        matrix[v][w] = matrix[w][v] = !matrix[v][w];
+
+        if(i % 211 != 0) continue;
+        for(int x=0; x<n; ++x) {
+            std::vector<int> expected = {};
+            for(int y=0; y<n; ++y) {
+                if(matrix[x][y]) expected.push_back(y);
+            }
+            if(M.neighbors(x) != expected || M.degree(x) != (int)expected.size()
+                || bitset_count(M.neighbors_row(x), M.bits_words()) != expected.size() || M.edge_has(x, v) != matrix[x][v]) {
+                ++failures;
+                std::cout << "########## Test failed - graph bits: n="<<n<<" neighbors of "<<x<<" "<<Graph::vector_tostring(M.neighbors(x))
+                    <<" != "<<Graph::vector_tostring(expected)<<" ##########\n";
+                break;
+            }
+        }
+    }
+    if(M.m() != edges) {
+        ++failures;
+        std::cout << "########## Test failed - graph bits: n="<<n<<" m="<<M.m()<<" != "<<edges<<" ##########\n";
+    }
+    if(failures == 0) std::cout << "Test success - graph bits\n";
+    return failures;
+}
+
+// random graph with n vertices, every edge with probability p
+Graph randomGraph(int n, double p, std::mt19937& random) {
+    Graph G(n);
+    std::bernoulli_distribution edge(p);
+    for(int v=0; v<n; ++v) {
+        for(int w=v+1; w<n; ++w) {
+            if(edge(random)) G.edge_add(v, w);
+        }
+    }
+    return G;
+}
+
+// random sorted unique vector with elements in [0, range)
+std::vector<int> randomSortedVector(std::mt19937& random, int range, double density) {
+    std::vector<int> vec = {};
+    std::bernoulli_distribution take(density);
+    for(int x=0; x<range; ++x) {
+        if(take(random)) vec.push_back(x);
+    }
+    return vec;
+}
+
+// every instruction set supported by this CPU has to compute the same results as the scalar kernels
+int test_set_kernels() {
+    int failures = 0;
+    std::mt19937 random(2);
+    const SetKernels scalar = SetKernelsGet("scalar");
+
+    for(const char* name : {"sse4.2", "avx2", "avx512"}) {
+        if(!SetKernelsSupported(name)) {
+            std::cout << "Test skipped - set kernels "<<name<<" (not supported)\n";
+            continue;
+        }
+        const SetKernels kernels = SetKernelsGet(name);
+
+        for(int i=0; i<2000 && failures == 0; ++i) {
+            const int range = 1 + random() % 300;
+            const auto a = randomSortedVector(random, range, (random() % 100) / 100.0);
+            const auto b = randomSortedVector(random, range, (random() % 100) / 100.0);
+
+            std::vector<int> expected(a.size() + 1), actual(a.size() + 1);
+            expected.resize(scalar.sorted_intersection(a.data(), a.size(), b.data(), b.size(), expected.data()));
+            actual.resize(kernels.sorted_intersection(a.data(), a.size(), b.data(), b.size(), actual.data()));
+            const bool intersectionOk = expected == actual
+                && kernels.sorted_intersection_count(a.data(), a.size(), b.data(), b.size()) == expected.size();
+
+            expected.resize(a.size() + 1);
+            actual.resize(a.size() + 1);
+            expected.resize(scalar.sorted_difference(a.data(), a.size(), b.data(), b.size(), expected.data()));
+            actual.resize(kernels.sorted_difference(a.data(), a.size(), b.data(), b.size(), actual.data()));
+            const bool differenceOk = expected == actual;
+
+            // bitsets with a word count that is not a multiple of the vector width
+            const size_t words = 1 + random() % 40;
+            std::vector<uint64_t> x(words), y(words), expectedBits(words), actualBits(words);
+            for(size_t w=0; w<words; ++w) {
+                x[w] = ((uint64_t)random() << 32) | random();
+                y[w] = ((uint64_t)random() << 32) | random();
+            }
+            scalar.bitset_and(expectedBits.data(), x.data(), y.data(), words);
+            kernels.bitset_and(actualBits.data(), x.data(), y.data(), words);
+            bool bitsOk = expectedBits == actualBits;
+            scalar.bitset_andnot(expectedBits.data(), x.data(), y.data(), words);
+            kernels.bitset_andnot(actualBits.data(), x.data(), y.data(), words);
+            bitsOk = bitsOk && expectedBits == actualBits
+                && scalar.bitset_count(x.data(), words) == kernels.bitset_count(x.data(), words)
+                && scalar.bitset_and_count(x.data(), y.data(), words) == kernels.bitset_and_count(x.data(), y.data(), words);
+
+            if(!intersectionOk || !differenceOk || !bitsOk) {
+                ++failures;
+                std::cout << "########## Test failed - set kernels "<<name<<": a="<<Graph::vector_tostring(a)
+                    <<" b="<<Graph::vector_tostring(b)<<" intersection="<<intersectionOk
+                    <<" difference="<<differenceOk<<" bitsets="<<bitsOk<<" ##########\n";
+            }
+        }
+    }
+    if(failures == 0) std::cout << "Test success - set kernels (selected: "<<setKernels.name<<")\n";
+    return failures;
+}
+
+// the count-only intersections have to agree with the size of the intersection, also for skewed sizes (galloping)
+int test_sorted_intersection_count() {
+    int failures = 0;
+    std::mt19937 random(3);
+
+    for(int i=0; i<3000 && failures == 0; ++i) {
+        const int range = 1 + random() % 2000;
+        const auto a = randomSortedVector(random, range, (random() % 100) / 100.0);
+        const auto b = randomSortedVector(random, range, (random() % 2 ? 0.01 : 1.0) * (random() % 100) / 100.0);
+
+        const size_t expected = Graph::sorted_intersection_unique(a, b).size();
+        bool ok = Graph::sorted_intersection_count(a, b) == expected && Graph::sorted_intersection_count(b, a) == expected;
+        for(size_t k : {(size_t)0, (size_t)1, (size_t)2, expected, expected + 1, (size_t)random() % 100}) {
+            ok = ok && Graph::sorted_intersection_count_at_least(a, b, k) == (expected >= k)
+                && Graph::sorted_intersection_count_at_least(b, a, k) == (expected >= k);
+        }
+        if(!ok) {
+            ++failures;
+            std::cout << "########## Test failed - sorted intersection count: |a|="<<a.size()<<" |b|="<<b.size()
+                <<" expected="<<expected<<" ##########\n";
+        }
+    }
+    if(failures == 0) std::cout << "Test success - sorted intersection count\n";
+    return failures;
+}
+
+// the degeneracy ordering has to remove a vertex of minimum remaining degree in every step
+int test_degeneracy_ordering() {
+    int failures = 0;
+    std::mt19937 random(4);
+    // reused for every graph: the ordering of a smaller graph after a larger one must not keep old vertices
+    DegeneracyAndOrdering info;
+
+    for(int i=0; i<300 && failures == 0; ++i) {
+        const int n = 1 + random() % 150;
+        Graph G = randomGraph(n, (random() % 100) / 100.0, random);
+
+        G.getDegeneracyOrdering(info);
+        std::vector<int> removed(n, 0);
+        int degeneracy = 0;
+        bool ok = info.ordering.size() == (size_t)n;
+        for(size_t j=0; ok && j<info.ordering.size(); ++j) {
+            const int vid = info.ordering[j];
+            // remaining degree of every vertex
+            int degreeMinimum = n;
+            int degreeHere = -1;
+            for(int v=0; v<n; ++v) {
+                if(removed[v]) continue;
+                int degree = 0;
+                for(int w : G.neighbors(v)) degree += !removed[w];
+                degreeMinimum = std::min(degreeMinimum, degree);
+                if(v == vid) degreeHere = degree;
+            }
+            ok = degreeHere == degreeMinimum;
+            degeneracy = std::max(degeneracy, degreeHere);
+            removed[vid] = 1;
+        }
+        if(!ok || degeneracy != info.degeneracy) {
+            ++failures;
+            std::cout << "########## Test failed - degeneracy ordering: n="<<n<<" degeneracy="<<info.degeneracy
+                <<" expected="<<degeneracy<<" ##########\n";
+        }
+    }
+    if(failures == 0) std::cout << "Test success - degeneracy ordering\n";
+    return failures;
+}
+
+// sorted list of sorted cliques
+std::vector<std::vector<int>> cliquesSorted(const MaximalCliquesInfo& info) {
+    std::vector<std::vector<int>> cliques = {};
+    for(const auto& clique : info.cliqueList) {
+        cliques.push_back(std::vector<int>(clique.begin(), clique.end()));
+        std::sort(cliques.back().begin(), cliques.back().end());
+    }
+    std::sort(cliques.begin(), cliques.end());
+    return cliques;
+}
+
+// the single word Bron-Kerbosch (n <= 64) has to find the same cliques as the multi word one (n > 64)
+int test_cliques_word() {
+    int failures = 0;
+    std::mt19937 random(5);
+
+    for(int i=0; i<200 && failures == 0; ++i) {
+        const int n = 1 + random() % 64;
+        // vertices n..64 of B stay isolated and are one additional clique each
+        Graph A = randomGraph(n, (random() % 100) / 100.0, random);
+        Graph B(65);
+        for(int v=0; v<n; ++v) {
+            for(int w=v+1; w<n; ++w) {
+                if(A.edge_has(v, w)) B.edge_add(v, w);
+            }
+        }
+
+        auto cliquesA = cliquesSorted(A.getMaximalCliques());
+        auto cliquesB = cliquesSorted(B.getMaximalCliques());
+        cliquesB.erase(std::remove_if(cliquesB.begin(), cliquesB.end(), [n](const std::vector<int>& clique) {
+            return clique.back() >= n;
+        }), cliquesB.end());
+
+        const size_t s = 1 + random() % 4;
+        const int vertex = A.getVertexInMoreThanSCliques(s);
+        size_t vertexCliques = 0;
+        for(const auto& clique : cliquesA) vertexCliques += vertex >= 0 && Graph::sorted_contains(clique, vertex);
+
+        if(cliquesA != cliquesB || (vertex >= 0) != (B.getVertexInMoreThanSCliques(s) >= 0) || (vertex >= 0 && vertexCliques <= s)) {
+            ++failures;
+            std::cout << "########## Test failed - cliques word: n="<<n<<" cliques="<<cliquesA.size()<<" != "<<cliquesB.size()
+                <<" or vertex in more than s="<<s<<" cliques="<<vertex<<" ##########\n";
+        }
+    }
+    if(failures == 0) std::cout << "Test success - cliques word\n";
+    return failures;
+}
+
+// sorted list of the sorted cliques of the clique index
+std::vector<std::vector<int>> cliquesSorted(const CliqueIndex& index, int n) {
+    std::vector<size_t> ids = {};
+    for(int v=0; v<n; ++v) ids.insert(ids.end(), index.vertex_cliques(v).begin(), index.vertex_cliques(v).end());
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+    std::vector<std::vector<int>> cliques = {};
+    for(size_t id : ids) cliques.push_back(index.clique(id));
+    std::sort(cliques.begin(), cliques.end());
+    return cliques;
+}
+
+// the clique index has to contain the maximal cliques of the graph after every edit and rollback
+int test_clique_index() {
+    int failures = 0;
+    std::mt19937 random(6);
+
+    for(int i=0; i<40 && failures == 0; ++i) {
+        // dense graphs have too many maximal cliques to compare after every step
+        const int n = 2 + random() % 50;
+        Graph G = randomGraph(n, (random() % 50) / 100.0, random);
+        CliqueIndex index(&G);
+
+        // stack of edits like the branch and bound: edge, checkpoint
+        std::vector<std::pair<std::pair<int,int>, size_t>> edits = {};
+        for(int step=0; step<60 && failures == 0; ++step) {
+            if(!edits.empty() && random() % 3 == 0) {
+                const auto edit = edits.back();
+                edits.pop_back();
+                const int v = edit.first.first, w = edit.first.second;
+                if(G.edge_has(v, w)) G.edge_remove(v, w);
+                else G.edge_add(v, w);
+                index.rollback(edit.second);
+            }
+            else {
+                const int v = random() % n;
+                const int w = random() % n;
+                if(v == w) continue;
+                edits.push_back({{v, w}, index.checkpoint()});
+                if(G.edge_has(v, w)) {
+                    G.edge_remove(v, w);
+                    index.edge_removed(v, w);
+                } else {
+                    G.edge_add(v, w);
+                    index.edge_added(v, w);
+                }
+            }
+
+            const auto expected = cliquesSorted(G.getMaximalCliques());
+            if(cliquesSorted(index, n) != expected || index.size() != expected.size()) {
+                ++failures;
+                std::cout << "########## Test failed - clique index: n="<<n<<" step="<<step<<" cliques="<<index.size()
+                    <<" expected="<<expected.size()<<" ##########\n";
+            }
+        }
+    }
+
+    // the branch and bound has to find solutions with the same minimal k
+    for(int i=0; i<30 && failures == 0; ++i) {
+        const int n = 3 + random() % 6;
+        const size_t s = 1 + random() % 2;
+        Graph G = randomGraph(n, 0.5, random);
+        for(bool fellows : {true, false}) {
+            int kMinimal[2] = {-1, -1};
+            for(int incremental=0; incremental<2; ++incremental) {
+                OverlappingEditingOptions options = {};
+                options.useFellowsForbidden = fellows;
+                options.incrementalCliques = incremental;
+                for(int k=0; k<=n*n && kMinimal[incremental] < 0; ++k) {
+                    if(!G.overlappingClusterEditingSolutionsBranchAndBound(s, k, options, 1).empty()) kMinimal[incremental] = k;
+                }
+            }
+            if(kMinimal[0] != kMinimal[1]) {
+                ++failures;
+                std::cout << "########## Test failed - clique index branch and bound: "<<G.to_graph6()<<" s="<<s
+                    <<" k="<<kMinimal[0]<<" != "<<kMinimal[1]<<" ##########\n";
+            }
+        }
+    }
+    if(failures == 0) std::cout << "Test success - clique index\n";
+    return failures;
+}
+
+// the neighborhood counts have to match the maximal cliques of the whole graph, also after edits and rollbacks of the cache
+int test_clique_counts() {
+    int failures = 0;
+    std::mt19937 random(7);
+
+    // sizes for single word rows, bitset rows and sorted vectors
+    for(int n : {1, 20, 64, 65, 150, GRAPH_H_BITSET_CLIQUES_MAX_N + 10}) {
+        for(int i=0; i<(n > 200 ? 1 : 3) && failures == 0; ++i) {
+            Graph G = randomGraph(n, n > 200 ? 4.0 / n : (random() % 50) / 100.0, random);
+
+            const auto info = G.getMaximalCliques(999999);
+            for(int v=0; v<n; ++v) {
+                const size_t expected = info.vertexCliques[v].size();
+                const size_t cap = random() % (expected + 3);
+                if(G.countMaximalCliquesContaining(v, cap) != std::min(expected, cap)) {
+                    ++failures;
+                    std::cout << "########## Test failed - clique counts: n="<<n<<" v="<<v<<" cap="<<cap
+                        <<" expected="<<expected<<" ##########\n";
+                    break;
+                }
+            }
+        }
+    }
+
+    for(int i=0; i<40 && failures == 0; ++i) {
+        const int n = 2 + random() % 40;
+        const size_t s = 1 + random() % 3;
+        Graph G = randomGraph(n, (random() % 50) / 100.0, random);
+        CliqueCountCache cache(&G);
+
+        // stack of edits like the branch and bound: edge, checkpoint
+        std::vector<std::pair<std::pair<int,int>, size_t>> edits = {};
+        for(int step=0; step<60 && failures == 0; ++step) {
+            if(!edits.empty() && random() % 3 == 0) {
+                const auto edit = edits.back();
+                edits.pop_back();
+                const int v = edit.first.first, w = edit.first.second;
+                if(G.edge_has(v, w)) G.edge_remove(v, w);
+                else G.edge_add(v, w);
+                cache.rollback(edit.second);
+            }
+            else {
+                const int v = random() % n;
+                const int w = random() % n;
+                if(v == w) continue;
+                edits.push_back({{v, w}, cache.checkpoint()});
+                if(G.edge_has(v, w)) G.edge_remove(v, w);
+                else G.edge_add(v, w);
+                cache.edge_changed(v, w);
+            }
+
+            const auto info = G.getMaximalCliques(999999);
+            for(int v=0; v<n; ++v) {
+                const size_t expected = std::min(info.vertexCliques[v].size(), s+1);
+                if(cache.count(v, s+1) != expected) {
+                    ++failures;
+                    std::cout << "########## Test failed - clique count cache: n="<<n<<" step="<<step<<" v="<<v
+                        <<" expected="<<expected<<" ##########\n";
+                    break;
+                }
+            }
+        }
+    }
+
+    // the branch and bound has to find solutions with the same minimal k
+    for(int i=0; i<30 && failures == 0; ++i) {
+        const int n = 3 + random() % 6;
+        const size_t s = 1 + random() % 2;
+        Graph G = randomGraph(n, 0.5, random);
+        int kMinimal[2] = {-1, -1};
+        for(int local=0; local<2; ++local) {
+            OverlappingEditingOptions options = {};
+            options.useFellowsForbidden = false;
+            options.localCliqueCounts = local;
+            for(int k=0; k<=n*n && kMinimal[local] < 0; ++k) {
+                if(!G.overlappingClusterEditingSolutionsBranchAndBound(s, k, options, 1).empty()) kMinimal[local] = k;
+            }
+        }
+        if(kMinimal[0] != kMinimal[1]) {
+            ++failures;
+            std::cout << "########## Test failed - clique counts branch and bound: "<<G.to_graph6()<<" s="<<s
+                <<" k="<<kMinimal[0]<<" != "<<kMinimal[1]<<" ##########\n";
+        }
+    }
+    if(failures == 0) std::cout << "Test success - clique counts\n";
+    return failures;
+}
+
+// counting the cliques per vertex (getVertexInMoreThanSCliques) has to stop at the same vertex as the clique lists,
+// and the clique indices of the lists have to be indices of the clique list (cliqueList.size()-1 underflowed without a list)
+int test_vertex_in_more_than_s_cliques() {
+    int failures = 0;
+    std::mt19937 random(8);
+
+    // sizes for single word rows, bitset rows and sorted vectors
+    for(int n : {1, 12, 40, 64, 65, 150, GRAPH_H_BITSET_CLIQUES_MAX_N + 10}) {
+        for(int i=0; i<(n > 200 ? 2 : 30) && failures == 0; ++i) {
+            // dense graphs only with few vertices: all maximal cliques are stored for the comparison
+            Graph G = randomGraph(n, n > 200 ? 6.0 / n : (random() % (n > 64 ? 30 : 80)) / 100.0, random);
+            const size_t s = 1 + random() % 4;
+
+            const int vertex = G.getVertexInMoreThanSCliques(s);
+            const int vertexLists = G.getMaximalCliques(s, true).vertexInMoreThanSCliques;
+
+            const auto info = G.getMaximalCliques(s);
+            bool indicesValid = true;
+            size_t cliquesMax = 0;
+            for(int v=0; v<n; ++v) {
+                cliquesMax = std::max(cliquesMax, info.vertexCliques[v].size());
+                for(const size_t id : info.vertexCliques[v]) {
+                    indicesValid = indicesValid && id < info.cliqueList.size()
+                        && std::find(info.cliqueList[id].begin(), info.cliqueList[id].end(), v) != info.cliqueList[id].end();
+                }
+            }
+
+            if(vertex != vertexLists || !indicesValid || (vertex < 0) != (cliquesMax <= s)
+                || (vertex >= 0 && info.vertexCliques[vertex].size() <= s)) {
+                ++failures;
+                std::cout << "########## Test failed - vertex in more than s cliques: n="<<n<<" s="<<s<<" vertex="<<vertex
+                    <<" lists="<<vertexLists<<" indices valid="<<indicesValid<<" ##########\n";
+            }
+        }
+    }
+    if(failures == 0) std::cout << "Test success - vertex in more than s cliques\n";
+    return failures;
+}
+
+// cliques enumerated on several threads have to be the same (and in the same order) as on one thread
+int test_cliques_parallel() {
+    int failures = 0;
+    std::mt19937 random(8);
+
+    // bitset and sorted vector subproblems
+    for(int n : {GRAPH_H_PARALLEL_CLIQUES_MIN_N, 700, GRAPH_H_BITSET_CLIQUES_MAX_N + 10}) {
+        Graph G = randomGraph(n, std::min(0.2, 20.0 / n), random);
+
+        const auto expected = G.getMaximalCliques(999999);
+        const std::vector<int> sValues = {1, 3, 10, 999999};
+        std::vector<int> verticesExpected = {};
+        for(int s : sValues) verticesExpected.push_back(G.getVertexInMoreThanSCliques(s));
+
+        for(unsigned int threads : {0u, 4u}) {
+            const auto info = G.getMaximalCliques(999999, false, threads);
+            if(info.cliqueList != expected.cliqueList || info.vertexCliques != expected.vertexCliques
+                || info.vertexInMoreThanSCliques != expected.vertexInMoreThanSCliques) {
+                ++failures;
+                std::cout << "########## Test failed - cliques parallel: n="<<n<<" threads="<<threads
+                    <<" cliques="<<info.cliqueList.size()<<" expected="<<expected.cliqueList.size()<<" ##########\n";
+            }
+
+            // stopping early: any vertex in more than s cliques
+            for(size_t i=0; i<sValues.size(); ++i) {
+                const int s = sValues[i];
+                const int vertex = G.getVertexInMoreThanSCliques(s, threads);
+                const int vertexExpected = verticesExpected[i];
+                if((vertex < 0) != (vertexExpected < 0) || (vertex >= 0 && expected.vertexCliques[vertex].size() <= size_t(s))) {
+                    ++failures;
+                    std::cout << "########## Test failed - cliques parallel stop: n="<<n<<" threads="<<threads<<" s="<<s
+                        <<" vertex="<<vertex<<" expected="<<vertexExpected<<" ##########\n";
+                }
+            }
+        }
+    }
+    if(failures == 0) std::cout << "Test success - cliques parallel\n";
+    return failures;
+}
+
+// the clique pool has to contain the same cliques, clique ids per vertex and bitsets as MaximalCliquesInfo (also when reused)
+int test_clique_pool() {
+    int failures = 0;
+    std::mt19937 random(9);
+
+    CliquePool pool;
+    pool.bitsEnabled = true;
+    for(int i=0; i<60 && failures == 0; ++i) {
+        const int n = i < 50 ? 1 + random() % 70 : GRAPH_H_PARALLEL_CLIQUES_MIN_N + random() % 100;
+        const size_t s = 1 + random() % 4;
+        const unsigned int threads = i % 2 ? 1 : 3;
+        Graph G = randomGraph(n, n > 100 ? 0.05 : (random() % 60) / 100.0, random);
+
+        const auto expected = G.getMaximalCliques(s);
+        G.getMaximalCliques(pool, s, false, threads);
+
+        bool equal = pool.size() == expected.cliqueList.size() && pool.vertexInMoreThanSCliques == expected.vertexInMoreThanSCliques;
+        for(size_t id=0; id<pool.size() && equal; ++id) {
+            const auto clique = pool.clique(id);
+            equal = std::vector<int>(clique.begin(), clique.end()) == expected.cliqueList[id]
+                && bitset_count(pool.clique_bits(id), pool.words) == clique.size();
+            for(const int v : clique) equal = equal && pool.clique_has(id, v);
+        }
+        for(int v=0; v<n && equal; ++v) {
+            const auto ids = pool.vertex_cliques(v);
+            equal = std::vector<size_t>(ids.begin(), ids.end()) == expected.vertexCliques[v];
+        }
+        if(!equal) {
+            ++failures;
+            std::cout << "########## Test failed - clique pool: n="<<n<<" s="<<s<<" threads="<<threads<<" cliques="<<pool.size()
+                <<" expected="<<expected.cliqueList.size()<<" ##########\n";
+        }
+    }
+    if(failures == 0) std::cout << "Test success - clique pool\n";
+    return failures;
+}
+
+// the clique callbacks have to see the same cliques as getMaximalCliques and stop when they return FALSE
+int test_clique_callback() {
+    int failures = 0;
+    std::mt19937 random(10);
+
+    for(int i=0; i<40 && failures == 0; ++i) {
+        const int n = 1 + random() % (i < 30 ? 70 : 300);
+        Graph G = randomGraph(n, n > 100 ? 0.05 : (random() % 60) / 100.0, random);
+        const auto expected = G.getMaximalCliques(999999);
+
+        // all cliques in the same order
+        std::vector<std::vector<int>> cliques = {};
+        bool complete = G.forEachMaximalClique([&cliques](const CliqueType& clique) {
+            cliques.push_back(clique);
+            return true;
+        });
+        bool equal = complete && cliques == expected.cliqueList;
+
+        // stop after `stop` cliques
+        const size_t stop = 1 + random() % expected.cliqueList.size();
+        size_t count = 0;
+        complete = G.forEachMaximalClique([&count, stop](const CliqueType&) {
+            return ++count < stop;
+        });
+        equal = equal && count == stop && complete == false;
+
+        // cliques containing u
+        const int u = random() % n;
+        cliques.clear();
+        complete = G.forEachMaximalCliqueContaining(u, [&cliques](const CliqueType& clique) {
+            cliques.push_back(clique);
+            return true;
+        });
+        std::vector<std::vector<int>> cliquesU = {};
+        for(const size_t id : expected.vertexCliques[u]) cliquesU.push_back(expected.cliqueList[id]);
+        for(auto& clique : cliques) std::sort(clique.begin(), clique.end());
+        for(auto& clique : cliquesU) std::sort(clique.begin(), clique.end());
+        std::sort(cliques.begin(), cliques.end());
+        std::sort(cliquesU.begin(), cliquesU.end());
+        equal = equal && complete && cliques == cliquesU;
+
+        // stop after `stopU` cliques containing u: exactly stopU calls
+        const size_t stopU = 1 + random() % cliquesU.size();
+        size_t countU = 0;
+        complete = G.forEachMaximalCliqueContaining(u, [&countU, stopU](const CliqueType&) {
+            return ++countU < stopU;
+        });
+        equal = equal && countU == stopU && complete == false;
+
+        if(!equal) {
+            ++failures;
+            std::cout << "########## Test failed - clique callback: n="<<n<<" u="<<u<<" stop="<<stop<<" count="<<count
+                <<" cliques="<<expected.cliqueList.size()<<" ##########\n";
+        }
+    }
+    if(failures == 0) std::cout << "Test success - clique callback\n";
+    return failures;
+}
+
+int test_clique_budget() {
+    int failures = 0;
+    std::mt19937 random(11);
+    CliquePool pool;
+
+    for(int i=0; i<40 && failures == 0; ++i) {
+        const int n = 1 + random() % 60;
+        Graph G = randomGraph(n, (random() % 60) / 100.0, random);
+        const auto expected = G.getMaximalCliques(999999);
+        const size_t count = expected.cliqueList.size();
+        size_t largest = 0;
+        for(const auto& clique : expected.cliqueList) largest = std::max(largest, clique.size());
+
+        // inside the budget: all cliques
+        bool equal = G.getMaximalCliques(pool, {.maxCliques = count, .minCliques = count, .maxCliqueSize = largest})
+            && pool.size() == count;
+        for(size_t id=0; id<pool.size() && equal; ++id) {
+            const auto clique = pool.clique(id);
+            equal = std::vector<int>(clique.begin(), clique.end()) == expected.cliqueList[id];
+        }
+        for(int v=0; v<n && equal; ++v) equal = pool.vertex_cliques(v).size() == expected.vertexCliques[v].size();
+
+        // one clique too many: stops right after the limit
+        if(count > 1) equal = equal && !G.getMaximalCliques(pool, {.maxCliques = count-1}) && pool.size() == count;
+        // one clique too few, too large cliques
+        equal = equal && !G.getMaximalCliques(pool, {.maxCliques = 0, .minCliques = count+1});
+        if(largest > 1) equal = equal && !G.getMaximalCliques(pool, {.maxCliques = 0, .minCliques = 0, .maxCliqueSize = largest-1});
+
+        if(!equal) {
+            ++failures;
+            std::cout << "########## Test failed - clique budget: n="<<n<<" cliques="<<count<<" largest="<<largest<<" ##########\n";
+        }
+    }
+    if(failures == 0) std::cout << "Test success - clique budget\n";
+    return failures;
+}
+
+int test_clique_prefilter() {
+    int failures = 0;
+    std::mt19937 random(12);
+    int certified = 0;
+
+    for(int i=0; i<300 && failures == 0; ++i) {
+        const int n = 1 + random() % (i < 250 ? 12 : 90);
+        Graph G = randomGraph(n, (random() % 100) / 100.0, random);
+
+        // a certificate is never wrong
+        for(const size_t s : {1, 2, 3, 5}) {
+            if(!G.cliquesAtMostSCertified(s)) continue;
+            ++certified;
+            if(G.getVertexInMoreThanSCliques(s) >= 0) {
+                ++failures;
+                std::cout << "########## Test failed - clique prefilter: n="<<n<<" s="<<s<<" certified wrongly ##########\n";
+            }
+        }
+    }
+
+    // complete multipartite neighborhoods: u adjacent to K_{2,2} is in 4 cliques, to K_{2,1} in 2 cliques
+    Graph G(5);
+    for(int v=1; v<5; ++v) G.edge_add(0, v);
+    G.edge_add(1, 3);
+    G.edge_add(1, 4);
+    G.edge_add(2, 3);
+    G.edge_add(2, 4);
+    const bool multipartite = G.cliquesAtMostSCertified(4) && !G.cliquesAtMostSCertified(3);
+    G.edge_remove(2, 4);
+    G.edge_remove(0, 4);
+    G.edge_remove(1, 4);
+    const bool smaller = G.cliquesAtMostSCertified(2) && !G.cliquesAtMostSCertified(1);
+
+    if(!multipartite || !smaller || certified == 0) {
+        ++failures;
+        std::cout << "########## Test failed - clique prefilter: multipartite="<<multipartite<<" smaller="<<smaller
+            <<" certified="<<certified<<" ##########\n";
+    }
+    if(failures == 0) std::cout << "Test success - clique prefilter\n";
+    return failures;
+}
+
+// the xor stream has to hold the same graph and cliques as parsing every line
+int test_graph6_stream() {
+    int failures = 0;
+    std::mt19937 random(13);
+    Graph6Stream stream = Graph6Stream(4);
+
+    int n = 1 + random() % 20;
+    Graph G(n);
+    for(int step=0; step<600 && failures == 0; ++step) {
+        // mostly a few edits, sometimes many edits or a different number of vertices
+        const int mode = random() % 20;
+        if(mode == 0) {
+            n = 1 + random() % 20;
+            G = Graph(n);
+        }
+        const int edits = mode == 1 ? 30 : random() % 4;
+        for(int i=0; i<edits && n > 1; ++i) {
+            const int v = random() % n;
+            const int w = (v + 1 + random() % (n - 1)) % n;
+            if(G.edge_has(v, w)) G.edge_remove(v, w);
+            else G.edge_add(v, w);
+        }
+
+        const std::string line = G.to_graph6();
+        stream.next(line);
+        const bool equal = stream.graph().to_graph6() == line
+            && cliquesSorted(stream.cliques(), n) == cliquesSorted(G.getMaximalCliques())
+            && stream.cliques().size() == G.getMaximalCliques().cliqueList.size();
+        if(!equal) {
+            ++failures;
+            std::cout << "########## Test failed - graph6 stream: n="<<n<<" step="<<step<<" line="<<line<<" ##########\n";
+        }
+    }
+    if(failures == 0 && (stream.stats.incremental == 0 || stream.stats.rebuilt < 2)) {
+        ++failures;
+        std::cout << "########## Test failed - graph6 stream: incremental="<<stream.stats.incremental
+            <<" rebuilt="<<stream.stats.rebuilt<<" ##########\n";
+    }
+    if(failures == 0) std::cout << "Test success - graph6 stream\n";
+    return failures;
+}
+
+// one graph reused for lines with different n has to be the same as a new graph per line
+int test_graph6_assign() {
+    int failures = 0;
+    std::mt19937 random(14);
+    Graph G = Graph(0);
+
+    for(int i=0; i<300 && failures == 0; ++i) {
+        const int n = random() % 63;
+        Graph expected = randomGraph(n, (random() % 100) / 100.0, random);
+
+        const std::string line = expected.to_graph6();
+        G.assign_graph6(line);
+        bool equal = (int)G.n() == n && G.m() == expected.m() && G.to_graph6() == line;
+        for(int v=0; v<n && equal; ++v) equal = G.neighbors(v) == expected.neighbors(v) && G.degree(v) == expected.degree(v);
+        if(!equal) {
+            ++failures;
+            std::cout << "########## Test failed - graph6 assign: n="<<n<<" line="<<line<<" ##########\n";
+        }
+    }
+
+    // bad characters and short lines are thrown, not read outside the line or the lookup table
+    for(const std::string& line : std::vector<std::string>({"D!c", "D\x80" "c", "D?\x7f", "Dc"})) {
+        bool thrown = false;
+        try {
+            G.assign_graph6(line);
+        }
+        catch(const std::runtime_error&) {
+            thrown = true;
+        }
+        if(!thrown) {
+            ++failures;
+            std::cout << "########## Test failed - graph6 assign: no exception for line="<<line<<" ##########\n";
+        }
+    }
+    if(failures == 0) std::cout << "Test success - graph6 assign\n";
+    return failures;
+}
+
+// graph6 and sparse6 of graphs with short and long headers have to be parsed back to the same graph
+int test_graph6_sparse6() {
+    int failures = 0;
+    std::mt19937 random(15);
+
+    auto sameGraph = [](const Graph& A, const Graph& B) {
+        bool equal = A.n() == B.n() && A.m() == B.m();
+        for(unsigned int v=0; v<A.n() && equal; ++v) equal = A.neighbors(v) == B.neighbors(v);
+        return equal;
+    };
+
+    // examples of formats.txt (nauty): edges 02 04 13 34 and edges 01 02 12 56 with n=7
+    Graph A(5);
+    A.edge_add(0, 2);
+    A.edge_add(0, 4);
+    A.edge_add(1, 3);
+    A.edge_add(3, 4);
+    Graph B(7);
+    B.edge_add(0, 1);
+    B.edge_add(0, 2);
+    B.edge_add(1, 2);
+    B.edge_add(5, 6);
+    if(A.to_graph6() != "DQc" || B.to_sparse6() != ":Fa@x^" || !sameGraph(Graph::parse_sparse6(":Fa@x^"), B)
+        || !sameGraph(Graph::parse_graph6(">>graph6<<DQc"), A)) {
+        ++failures;
+        std::cout << "########## Test failed - graph6 sparse6: examples graph6="<<A.to_graph6()<<" sparse6="<<B.to_sparse6()<<" ##########\n";
+    }
+
+    Graph G = Graph(0);
+    for(int i=0; i<200 && failures == 0; ++i) {
+        // around 62/63 (long header) and 64/65 (multiple words per row), n = 2^k for the sparse6 padding
+        const int n = i < 20 ? 60 + i % 8 : (i < 40 ? 1 << (i % 8) : random() % 300);
+        Graph expected = randomGraph(n, (random() % 100) / 100.0, random);
+        // sparse6 padding after an edge of vertex n-2
+        if(i % 2 == 0 && n >= 3) {
+            for(int v=0; v<n-1; ++v) {
+                if(expected.edge_has(v, n-1)) expected.edge_remove(v, n-1);
+            }
+        }
+
+        const std::string g6 = expected.to_graph6();
+        const std::string s6 = expected.to_sparse6();
+        bool equal = (n <= 62) == (g6[0] != '~') && sameGraph(Graph::parse_graph6(g6), expected);
+        G.assign_sparse6(s6);
+        equal = equal && sameGraph(G, expected) && G.to_graph6() == g6;
+        if(!equal) {
+            ++failures;
+            std::cout << "########## Test failed - graph6 sparse6: n="<<n<<" m="<<expected.m()<<" sparse6="<<s6<<" ##########\n";
+        }
+    }
+
+    // bad characters in the header or the edges and headers with too many vertices are thrown
+    for(const std::string& line : std::vector<std::string>({"~!!!", "~~??????", "~~??@???", ":D!c", ":Fa@x\x80", "~~~~~~~~"})) {
+        bool thrown = false;
+        try {
+            if(line[0] == ':') G.assign_sparse6(line);
+            else G.assign_graph6(line);
+        }
+        catch(const std::runtime_error&) {
+            thrown = true;
+        }
+        // ~~?????? is a valid header with n=0
+        if(thrown == (line == "~~??????")) {
+            ++failures;
+            std::cout << "########## Test failed - graph6 sparse6: exception="<<thrown<<" for line="<<line<<" ##########\n";
+        }
+    }
+    if(failures == 0) std::cout << "Test success - graph6 sparse6\n";
+    return failures;
+}
+
+// graphs written as binary records have to be read back with the same index and payload, also after seeking
+int test_graph_binary() {
+    int failures = 0;
+    std::mt19937 random(16);
+
+    for(const int n : {0, 1, 2, 9, 64, 65, 130}) {
+        std::vector<std::string> lines = {};
+        FILE* file = tmpfile();
+        {
+            GraphBinaryHeader header = GraphBinaryHeader();
+            header.n = n;
+            header.payloadBytes = 4;
+            header.flags = GRAPH_BINARY_INDEXED;
+            GraphBinaryWriter writer = GraphBinaryWriter(file, header);
+            for(int i=0; i<20; ++i) {
+                Graph G = randomGraph(n, (random() % 100) / 100.0, random);
+                lines.push_back(G.to_graph6());
+                const uint32_t payload = 1000 + i;
+                if(i % 2 == 0) writer.write(G, 7 * i, &payload);
+                else writer.write_graph6(lines.back(), 7 * i, &payload);
+            }
+        }
+        rewind(file);
+
+        GraphBinaryReader reader = GraphBinaryReader(file);
+        Graph G = Graph(0);
+        size_t read = 0;
+        bool equal = reader.header().n == (uint32_t)n;
+        while(equal && reader.next()) {
+            reader.assign(G);
+            equal = read < lines.size() && G.to_graph6() == lines[read] && reader.to_graph6() == lines[read]
+                && reader.index() == 7 * read && binary_get(reader.payload(), 4) == 1000 + read;
+            ++read;
+        }
+        reader.seek(13);
+        equal = equal && read == lines.size() && reader.next() && reader.index() == 7 * 13 && reader.to_graph6() == lines[13];
+        fclose(file);
+
+        if(!equal) {
+            ++failures;
+            std::cout << "########## Test failed - graph binary: n="<<n<<" read="<<read<<" ##########\n";
+        }
+    }
+    if(failures == 0) std::cout << "Test success - graph binary\n";
+    return failures;
+}
+
+// the mmapped corpus has to return the same graphs as reading the records one after another
+int test_graph_corpus() {
+    int failures = 0;
+    std::mt19937 random(17);
+
+    char path[] = "/tmp/graphCorpusTestXXXXXX";
+    const int fd = mkstemp(path);
+    FILE* file = fdopen(fd, "w");
+    std::vector<std::string> lines = {};
+    {
+        GraphBinaryHeader header = GraphBinaryHeader();
+        header.n = 11;
+        header.flags = GRAPH_BINARY_INDEXED;
+        GraphBinaryWriter writer = GraphBinaryWriter(file, header);
+        for(int i=0; i<500; ++i) {
+            Graph G = randomGraph(11, 0.5, random);
+            lines.push_back(G.to_graph6());
+            writer.write(G, i);
+        }
+    }
+    fclose(file);
+
+    {
+        GraphCorpus corpus = GraphCorpus(path);
+        Graph G = Graph(0);
+        bool equal = corpus.size() == lines.size();
+        for(int i=0; i<100 && equal; ++i) {
+            const size_t record = random() % lines.size();
+            corpus.assign(record, G);
+            equal = corpus.index(record) == record && G.to_graph6() == lines[record] && corpus.to_graph6(record) == lines[record];
+        }
+        if(!equal) {
+            ++failures;
+            std::cout << "########## Test failed - graph corpus: size="<<corpus.size()<<" ##########\n";
+        }
+    }
+    unlink(path);
+
+    if(failures == 0) std::cout << "Test success - graph corpus\n";
+    return failures;
+}
+
+int test_graph_corpus_compressed() {
+    int failures = 0;
+    std::mt19937 random(19);
+
+    char path[] = "/tmp/graphCorpusCompressedTestXXXXXX";
+    const int fd = mkstemp(path);
+    FILE* file = fdopen(fd, "w");
+    std::vector<std::string> lines = {};
+    {
+        // random walk: a few edge flips per graph like consecutive graphs of geng
+        GraphCompressedWriter writer = GraphCompressedWriter(file, 11, 64);
+        Graph G(11);
+        for(int i=0; i<1000; ++i) {
+            for(int flips = random() % 4; flips > 0; --flips) {
+                const int v = random() % 11;
+                const int w = (v + 1 + random() % 10) % 11;
+                if(G.edge_has(v, w)) G.edge_remove(v, w);
+                else G.edge_add(v, w);
+            }
+            lines.push_back(G.to_graph6());
+            writer.write(G);
+        }
+        writer.finish();
+    }
+    fclose(file);
+
+    {
+        GraphCorpus corpus = GraphCorpus(path);
+        Graph G = Graph(0);
+        bool equal = corpus.size() == lines.size();
+        // in order
+        for(size_t record=0; record<corpus.size() && equal; ++record) {
+            corpus.assign(record, G);
+            equal = G.to_graph6() == lines[record];
+        }
+        // random access (other blocks and backwards)
+        for(int i=0; i<200 && equal; ++i) {
+            const size_t record = random() % lines.size();
+            equal = corpus.index(record) == record && corpus.to_graph6(record) == lines[record];
+        }
+        if(!equal) {
+            ++failures;
+            std::cout << "########## Test failed - graph corpus compressed: size="<<corpus.size()<<" ##########\n";
+        }
+    }
+
+    // corrupt copies: thrown instead of reading or writing outside of the file and the decoded record
+    std::vector<uint8_t> bytes = {};
+    {
+        FILE* in = fopen(path, "r");
+        for(int c = fgetc(in); c != EOF; c = fgetc(in)) bytes.push_back(c);
+        fclose(in);
+    }
+    const uint64_t indexOffset = binary_get(bytes.data() + bytes.size() - 8, 8);
+    const size_t lastBlock = (lines.size() - 1) / 64;
+    for(int corruption=0; corruption<2; ++corruption) {
+        std::vector<uint8_t> corrupt = bytes;
+        size_t badRecord = 0;
+        // offset of the last block behind the blocks
+        if(corruption == 0) {
+            binary_put(corrupt.data() + indexOffset + 8 * lastBlock, indexOffset + 1, 8);
+            badRecord = lines.size() - 1;
+        }
+        // mask of the first record with a bit after the 7 bytes of the triangle (n=11)
+        if(corruption == 1) {
+            corrupt[GRAPH_BINARY_HEADER_BYTES] = 0xff;
+        }
+        FILE* out = fopen(path, "w");
+        fwrite(corrupt.data(), 1, corrupt.size(), out);
+        fclose(out);
+
+        GraphCorpus corpus = GraphCorpus(path);
+        bool thrown = false;
+        try {
+            corpus.triangle(badRecord);
+        }
+        catch(const std::runtime_error&) {
+            thrown = true;
+        }
+        // the other blocks are still decoded after the exception
+        const bool otherBlock = corpus.to_graph6(64) == lines[64];
+        if(!thrown || !otherBlock) {
+            ++failures;
+            std::cout << "########## Test failed - graph corpus compressed: corruption "<<corruption<<" thrown="<<thrown<<" ##########\n";
+        }
+    }
+    unlink(path);
+
+    if(failures == 0) std::cout << "Test success - graph corpus compressed\n";
+    return failures;
+}
+
+int test_canonical_form() {
+    int failures = 0;
+    std::mt19937 random(23);
+    CanonicalForm canonical = CanonicalForm();
+
+    // all labeled graphs with 5 and 6 vertices: 34 and 156 isomorphism classes
+    const std::vector<std::pair<int, size_t>> classes = {{5, 34}, {6, 156}};
+    for(const auto& [n, expected] : classes) {
+        std::unordered_set<std::string> forms = {};
+        const int pairs = n * (n - 1) / 2;
+        for(long mask=0; mask < (1l << pairs); ++mask) {
+            Graph G(n);
+            int bit = 0;
+            for(int v=0; v<n; ++v) {
+                for(int w=v+1; w<n; ++w, ++bit) {
+                    if((mask >> bit) & 1) G.edge_add(v, w);
+                }
+            }
+            forms.insert(canonical.graph6(G));
+        }
+        if(forms.size() != expected) {
+            ++failures;
+            std::cout << "########## Test failed - canonical form: n="<<n<<" classes="<<forms.size()<<" expected="<<expected<<" ##########\n";
+        }
+    }
+
+    // symmetric graphs with 16 vertices on Z4 x Z4: 4x4 rook graph and Shrikhande graph (both strongly regular (16,6,2,2)), C16, empty
+    std::vector<Graph> graphs = {};
+    const std::vector<std::vector<std::pair<int, int>>> connections = {
+        {{1, 0}, {2, 0}, {3, 0}, {0, 1}, {0, 2}, {0, 3}},
+        {{1, 0}, {3, 0}, {0, 1}, {0, 3}, {1, 1}, {3, 3}},
+    };
+    for(const auto& connection : connections) {
+        Graph G(16);
+        for(int v=0; v<16; ++v) {
+            for(const auto& [x, y] : connection) {
+                const int w = ((v / 4 + x) % 4) * 4 + (v % 4 + y) % 4;
+                if(v < w) G.edge_add(v, w);
+            }
+        }
+        graphs.push_back(G);
+    }
+    Graph cycle(16);
+    for(int v=0; v<16; ++v) cycle.edge_add(v, (v + 1) % 16);
+    graphs.push_back(cycle);
+    graphs.push_back(Graph(16));
+
+    std::vector<std::string> forms = {};
+    for(const auto& G : graphs) {
+        const std::string form = canonical.graph6(G);
+        bool equal = std::find(forms.begin(), forms.end(), form) == forms.end() && canonical.leaves < 1000;
+        forms.push_back(form);
+
+        // random relabelings have the same canonical form
+        std::vector<int> relabel = std::vector<int>(16);
+        for(int v=0; v<16; ++v) relabel[v] = v;
+        for(int i=0; i<20 && equal; ++i) {
+            std::shuffle(relabel.begin(), relabel.end(), random);
+            Graph H(16);
+            for(int v=0; v<16; ++v) {
+                for(int w=v+1; w<16; ++w) {
+                    if(G.edge_has(v, w)) H.edge_add(relabel[v], relabel[w]);
+                }
+            }
+            equal = canonical.graph6(H) == form && canonical.invariant(H) == canonical.invariant(G);
+        }
+        if(!equal) {
+            ++failures;
+            std::cout << "########## Test failed - canonical form: graph="<<G.to_graph6()<<" leaves="<<canonical.leaves<<" ##########\n";
+        }
+    }
+
+    if(failures == 0) std::cout << "Test success - canonical form\n";
+    return failures;
+}
+
+int test_string_set() {
+    int failures = 0;
+    std::mt19937 random(29);
+
+    // graph6 alphabet (6 bits per character) and other strings (8 bits), short strings with many duplicates
+    StringSet set = StringSet(4);
+    std::unordered_set<std::string> expected = {};
+    bool equal = true;
+    for(int i=0; i<20000 && equal; ++i) {
+        std::string key = std::string(random() % 6, ' ');
+        const bool graph6 = random() % 4 != 0;
+        for(auto& c : key) c = graph6 ? 63 + random() % 4 : 32 + random() % 95;
+        equal = set.insert(key) == expected.insert(key).second;
+    }
+    for(int i=0; i<1000 && equal; ++i) {
+        const std::string key = std::string(random() % 6, (char)(63 + random() % 64));
+        equal = set.contains(key) == (expected.find(key) != expected.end());
+    }
+    if(!equal || set.size() != expected.size()) {
+        ++failures;
+        std::cout << "########## Test failed - string set: size="<<set.size()<<" expected="<<expected.size()<<" ##########\n";
+    }
+
+    if(failures == 0) std::cout << "Test success - string set\n";
+    return failures;
+}
+
+int test_external_unique() {
+    int failures = 0;
+    std::mt19937 random(31);
+
+    std::vector<std::string> lines = {};
+    for(int i=0; i<5000; ++i) lines.push_back(std::to_string(random() % 2000));
+    // expected: first seen order and sorted
+    std::vector<std::string> firstSeen = {};
+    std::unordered_set<std::string> seen = {};
+    for(const auto& line : lines) {
+        if(seen.insert(line).second) firstSeen.push_back(line);
+    }
+    std::vector<std::string> sorted = firstSeen;
+    std::sort(sorted.begin(), sorted.end());
+
+    // 4 KB: many runs, all in memory
+    for(const size_t memoryBytes : {(size_t)4096, (size_t)1 << 30}) {
+        for(const bool firstSeenOrder : {false, true}) {
+            ExternalUnique unique = ExternalUnique(memoryBytes, "/tmp", firstSeenOrder);
+            for(const auto& line : lines) unique.add(line);
+            std::vector<std::string> printed = {};
+            unique.finish([&printed](const std::string& line) {
+                printed.push_back(line);
+            });
+            if(printed != (firstSeenOrder ? firstSeen : sorted) || (memoryBytes == 4096) != (unique.runsWritten > 1)) {
+                ++failures;
+                std::cout << "########## Test failed - external unique: memory="<<memoryBytes<<" firstSeenOrder="<<firstSeenOrder
+                    <<" printed="<<printed.size()<<" expected="<<firstSeen.size()<<" runs="<<unique.runsWritten<<" ##########\n";
+            }
+        }
+    }
+
+    if(failures == 0) std::cout << "Test success - external unique\n";
+    return failures;
+}
+
+int test_parallel_unique() {
+    int failures = 0;
+    std::mt19937 random(37);
+
+    std::string input = "";
+    std::vector<std::string> expected = {};
+    std::unordered_set<std::string> seen = {};
+    for(int i=0; i<20000; ++i) {
+        const std::string line = std::to_string(random() % 5000);
+        input += line + "\n";
+        if(seen.insert(line).second) expected.push_back(line);
+    }
+
+    for(const bool arrivalOrder : {true, false}) {
+        // small batches: many batches in flight
+        ParallelUnique unique = ParallelUnique(4, arrivalOrder, 100);
+        std::istringstream stream = std::istringstream(input);
+        std::vector<std::string> printed = {};
+        unique.run(stream, [&printed](const std::string& line) {
+            printed.push_back(line);
+        });
+        // unordered: same lines in any order
+        std::vector<std::string> wanted = expected;
+        if(!arrivalOrder) {
+            std::sort(printed.begin(), printed.end());
+            std::sort(wanted.begin(), wanted.end());
+        }
+        if(printed != wanted || unique.size() != expected.size()) {
+            ++failures;
+            std::cout << "########## Test failed - parallel unique: arrivalOrder="<<arrivalOrder<<" printed="<<printed.size()<<" expected="<<expected.size()<<" ##########\n";
+        }
+    }
+
+    if(failures == 0) std::cout << "Test success - parallel unique\n";
+    return failures;
+}
+
+int test_spsc_ring() {
+    int failures = 0;
+
+    // small ring: the producer waits for the consumer many times
+    SpscRing<std::vector<int>> ring = SpscRing<std::vector<int>>(3);
+    std::thread producer = std::thread([&ring]() {
+        for(int i=0; i<20000; ++i) ring.push(std::vector<int>(1 + i % 5, i));
+        ring.close();
+    });
+    std::vector<int> item = {};
+    int expected = 0;
+    bool equal = true;
+    while(ring.pop(item)) {
+        equal = equal && item.size() == (size_t)(1 + expected % 5) && item.back() == expected;
+        ++expected;
+    }
+    producer.join();
+    if(!equal || expected != 20000) {
+        ++failures;
+        std::cout << "########## Test failed - spsc ring: popped="<<expected<<" ##########\n";
+    }
+
+    if(failures == 0) std::cout << "Test success - spsc ring\n";
+    return failures;
+}
+
+int test_forbidden_pipeline() {
+    int failures = 0;
+    std::mt19937 random(41);
+    const size_t s = 3;
+
+    // random graphs with 7 to 10 vertices: the batches also change with n
+    std::string input = "";
+    const size_t graphs = 400;
+    for(size_t i=0; i<graphs; ++i) {
+        const int n = 7 + i % 4;
+        input += randomGraph(n, 0.6, random).to_graph6() + "\n";
+    }
+
+    // expected: findMinimalForbidden and unique canonical graph6 on one thread (minimalForbiddenGenerate -u)
+    OverlappingEditingOptions options = {
+        .useFellowsForbidden = false,
+        .useForbiddenCliques = true,
+    };
+    std::vector<CliqueType> cliquesOverlappingU = {};
+    std::vector<int> forbiddenVertices = {};
+    CanonicalForm canonical = CanonicalForm();
+    std::unordered_set<std::string> seen = {};
+    std::vector<std::string> expected = {};
+    std::istringstream lines = std::istringstream(input);
+    std::string line;
+    while(std::getline(lines, line)) {
+        Graph G = Graph(0);
+        G.assign_graph6(line);
+        bool prefilterDecided = false;
+        if(!findMinimalForbidden(&G, s, options, cliquesOverlappingU, forbiddenVertices, prefilterDecided)) continue;
+
+        const std::string graph6 = canonical.graph6(G.getSubgraph(forbiddenVertices));
+        if(seen.insert(graph6).second) expected.push_back(graph6);
+    }
+    if(expected.empty()) {
+        ++failures;
+        std::cout << "########## Test failed - forbidden pipeline: no forbidden subgraph in the random graphs ##########\n";
+    }
+
+    // small batches: many batches in flight, the same output in the same order for every number of threads
+    for(const unsigned int threads : {1u, 2u, 3u}) {
+        ForbiddenPipeline pipeline = ForbiddenPipeline(s, threads, 16);
+        std::istringstream stream = std::istringstream(input);
+        std::vector<std::string> printed = {};
+        pipeline.run(stream, [&printed](const std::string& graph6) {
+            printed.push_back(graph6);
+        });
+        if(printed != expected || pipeline.graphs() != graphs || pipeline.size() != expected.size()) {
+            ++failures;
+            std::cout << "########## Test failed - forbidden pipeline: threads="<<threads<<" printed="<<printed.size()<<" expected="<<expected.size()<<" ##########\n";
+        }
+    }
+
+    // a bad line in the input: thrown by run() after all threads finished
+    bool thrown = false;
+    try {
+        ForbiddenPipeline pipeline = ForbiddenPipeline(s, 2, 16);
+        std::istringstream stream = std::istringstream(input + "!\n");
+        pipeline.run(stream, [](const std::string&) {});
+    }
+    catch(const std::runtime_error&) {
+        thrown = true;
+    }
+    if(!thrown) {
+        ++failures;
+        std::cout << "########## Test failed - forbidden pipeline: no exception for a bad line ##########\n";
+    }
+
+    if(failures == 0) std::cout << "Test success - forbidden pipeline\n";
+    return failures;
+}
+
+int test() {
+    int failures = 0;
+    failures += test_graph_bits();
+    failures += test_set_kernels();
+    failures += test_sorted_intersection_count();
+    failures += test_degeneracy_ordering();
+    failures += test_cliques_word();
+    failures += test_clique_index();
+    failures += test_clique_counts();
+    failures += test_vertex_in_more_than_s_cliques();
+    failures += test_cliques_parallel();
+    failures += test_clique_pool();
+    failures += test_clique_callback();
+    failures += test_clique_budget();
+    failures += test_clique_prefilter();
+    failures += test_graph6_stream();
+    failures += test_graph6_assign();
+    failures += test_graph6_sparse6();
+    failures += test_graph_binary();
+    failures += test_graph_corpus();
+    failures += test_graph_corpus_compressed();
+    failures += test_canonical_form();
+    failures += test_string_set();
+    failures += test_external_unique();
+    failures += test_parallel_unique();
+    failures += test_spsc_ring();
+    failures += test_forbidden_pipeline();
+    return failures;
+}
+
+int main(int argc, char* argv[]) {
     std::cout << "Starting\n";
 
+    // t: run tests instead
+    for(int i=1; i<argc; ++i) {
+        std::string option = argv[i];
+        if(option == "-t") {
+            auto failures = test();
+            std::cout << "Finished tests with "<<failures<<" failures\n";
+            return failures ? 1 : 0;
+        }
+    }
+
     // testGraph();
     // testForbiddenSizeRemovingTwoRandomEdgesOfTrianglesLowerBound();
     cliqueSeparatorWorstCase();
@@ -64,9 +64,25 @@ void testThreeCliquesOverlappingTest(int graphsCount, std::string& line, Graph*
     }*/
 }
 
+// maximal cliques of the current graph. Reused for every graph of the stream: no memory is allocated per clique
+CliquePool cliquePool;
+
+// the maximal cliques of G as sets. Empty if G is outside the budget
+std::vector<std::unordered_set<int>> cliqueSetsGet(Graph* G, const CliqueBudget& budget) {
+    if(!G->getMaximalCliques(cliquePool, budget)) return {};
+
+    std::vector<std::unordered_set<int>> cliques = {};
+    cliques.reserve(cliquePool.size());
+    for(size_t id=0; id<cliquePool.size(); ++id) {
+        const auto clique = cliquePool.clique(id);
+        cliques.push_back(std::unordered_set<int>(clique.begin(), clique.end()));
+    }
+    return cliques;
+}
+
 int intersectionsFoundMin = 100;
-void testThreeCliquesOverlapping(int graphsCount, std::string line) {
-    Graph GraphValue = Graph::parse_graph6(line);
+void testThreeCliquesOverlapping(int graphsCount, Graph& GraphValue, std::string line) {
+    GraphValue.assign_graph6(line);
     Graph* G = &GraphValue;
 
     // get all cliques
@@ -267,8 +283,8 @@ void testFourCliquesOverlappingTest(int graphsCount, std::string& line, Graph* G
     }
 }
 
-void testFourCliquesOverlapping(int graphsCount, std::string line) {
-    Graph GraphValue = Graph::parse_graph6(line);
+void testFourCliquesOverlapping(int graphsCount, Graph& GraphValue, std::string line) {
+    GraphValue.assign_graph6(line);
 
     Graph* G = &GraphValue;
 
@@ -530,8 +546,8 @@ void testThreeCliquesSeparatorTest(int graphsCount, std::string& line, Graph* G,
         exit(1);
     }
 }
-void testThreeCliquesSeparator(int graphsCount, std::string line) {
-    Graph GraphValue = Graph::parse_graph6(line);
+void testThreeCliquesSeparator(int graphsCount, Graph& GraphValue, std::string line) {
+    GraphValue.assign_graph6(line);
     Graph* G = &GraphValue;
 
     // get all cliques
@@ -663,34 +679,31 @@ void testThreeCliquesSeparator(int graphsCount, std::string line) {
 }
 
 
-void lookForGraphWhereEveryVertexIsInHighAmountOfCliques(int graphsCount, std::string line) {
-    Graph GraphValue = Graph::parse_graph6(line);
+void lookForGraphWhereEveryVertexIsInHighAmountOfCliques(int graphsCount, Graph& GraphValue, std::string line) {
+    GraphValue.assign_graph6(line);
     size_t s = 8;
     // size_t vertexInThisAmountOfCliques = s - 4;
     size_t vertexInThisAmountOfCliques = 5;
 
     Graph* G = &GraphValue;
 
-    // get all cliques
-    auto cliqueInfo = G->getMaximalCliques(999999);
-
-    // only want three cliques
-    if(cliqueInfo.cliqueList.size() != s) {
-        // std::cout << "########### New graph "<<graphsCount<<": "<<line<<" has "<<cliqueInfo.cliqueList.size()<<" cliques - skipping.\n";
+    // only want s cliques: stops after s+1 cliques
+    if(!G->getMaximalCliques(cliquePool, {.maxCliques = s, .minCliques = s})) {
+        // std::cout << "########### New graph "<<graphsCount<<": "<<line<<" has "<<cliquePool.size()<<" cliques - skipping.\n";
         return;
     }
 
     size_t minFound = 10000;
     for(unsigned int i=0; i<G->n(); ++i) {
-        auto& cliquesOverlapping = cliqueInfo.vertexCliques[i];
-        minFound = std::min(minFound, cliquesOverlapping.size());
-        //std::cout << "\tvertex="<<i<<": "<<cliquesOverlapping.size()<<"\n";
+        minFound = std::min(minFound, cliquePool.vertex_cliques(i).size());
+        //std::cout << "\tvertex="<<i<<": "<<cliquePool.vertex_cliques(i).size()<<"\n";
         if(minFound < vertexInThisAmountOfCliques) {
             return;
         }
     }
     if(minFound < vertexInThisAmountOfCliques) {
         /*if(minFound == vertexInThisAmountOfCliques-1) {
+            auto cliqueInfo = G->getMaximalCliques(999999);
             std::cout << "########### New graph "<<graphsCount<<": "<<line
                 <<" cliques="<<Graph::vector_tostring(cliqueInfo.cliqueList)
                 <<" verticesCliques="<<Graph::vector_tostring(cliqueInfo.vertexCliques)<<"\n";
@@ -698,19 +711,21 @@ void lookForGraphWhereEveryVertexIsInHighAmountOfCliques(int graphsCount, std::s
         return;
     }
 
+    // get all cliques of the example
+    auto cliqueInfo = G->getMaximalCliques(999999);
     std::cout << "########### New graph "<<graphsCount<<": "<<line<<" is an example."
         <<" cliques="<<Graph::vector_tostring(cliqueInfo.cliqueList)
         <<" verticesCliques="<<Graph::vector_tostring(cliqueInfo.vertexCliques)<<"\n";
     exit(1);
 }
 
-void cliquesMinimumNumberOfCliquesPerVertex(std::string line, std::vector<int>& numberOfCliquesWithCHalf) {
-    Graph GraphValue = Graph::parse_graph6(line);
+void cliquesMinimumNumberOfCliquesPerVertex(Graph& GraphValue, std::string line, std::vector<int>& numberOfCliquesWithCHalf) {
+    GraphValue.assign_graph6(line);
     Graph* G = &GraphValue;
 
     // get all cliques
-    auto cliqueInfo = G->getMaximalCliques(999999);
-    size_t s = cliqueInfo.cliqueList.size();
+    G->getMaximalCliques(cliquePool);
+    size_t s = cliquePool.size();
     while(numberOfCliquesWithCHalf.size() < s) {
         numberOfCliquesWithCHalf.push_back(99+numberOfCliquesWithCHalf.size());
     }
@@ -718,10 +733,9 @@ void cliquesMinimumNumberOfCliquesPerVertex(std::string line, std::vector<int>&
 
     // for every clique
     int countCliques = 0;
-    for(auto& clique : cliqueInfo.cliqueList) {
-        for(auto v : clique) {
-            auto& cliquesOverlapping = cliqueInfo.vertexCliques[v];
-            if(cliquesOverlapping.size() > bound) continue;
+    for(size_t id=0; id<cliquePool.size(); ++id) {
+        for(auto v : cliquePool.clique(id)) {
+            if(cliquePool.vertex_cliques(v).size() > bound) continue;
             ++countCliques;
             break;
         }
@@ -826,7 +840,7 @@ std::vector<int> cliqueSeparatorWorstCaseFind(int graphsCount, Graph* G,
 }
 
 // trying all separators, we look for the smallest set of separators. What is the MAXIMUM of that smallest set (depending on the number of cliques)?
-void cliqueSeparatorWorstCase(int graphsCount, std::string line, int& numberOfCliquesToSeparatorSize) {
+void cliqueSeparatorWorstCase(int graphsCount, Graph& GraphValue, std::string line, int& numberOfCliquesToSeparatorSize) {
     /* Results on connected and non-connected graphs:
          cliques: 2, separators: 2
     n=8: cliques: 3, separators: 4
@@ -841,17 +855,11 @@ void cliqueSeparatorWorstCase(int graphsCount, std::string line, int& numberOfCl
     size_t c = 4;
     int propositionMinimum = 6;
 
-    Graph GraphValue = Graph::parse_graph6(line);
+    GraphValue.assign_graph6(line);
     Graph* G = &GraphValue;
 
-    // get all cliques
-    auto cliqueInfo = G->getMaximalCliques(999999);
-
-    // create sets out of the cliques
-    std::vector<std::unordered_set<int>> cliques = {};
-    for(auto& clique : cliqueInfo.cliqueList) {
-        cliques.push_back(std::unordered_set<int>(clique.begin(), clique.end()));
-    }
+    // get all cliques as sets
+    std::vector<std::unordered_set<int>> cliques = cliqueSetsGet(G, {.maxCliques = 0, .minCliques = c});
     
     // lambda to receive the indices and call the solver function
     auto lambda = [graphsCount,&line,G,&numberOfCliquesToSeparatorSize,&cliques,&propositionMinimum](size_t, std::vector<size_t> indices) {
@@ -866,8 +874,8 @@ void cliqueSeparatorWorstCase(int graphsCount, std::string line, int& numberOfCl
     };
 
     // try ALL subsets of cliques: size at least 3, since for 2 cliques we need at most 2 separators
-    // if(cliqueInfo.cliqueList.size() < 3) return;
-    /*for(size_t s = 3; s <= cliqueInfo.cliqueList.size(); ++s) {
+    // if(cliques.size() < 3) return;
+    /*for(size_t s = 3; s <= cliques.size(); ++s) {
         SubsetsOfSizeLoop(cliques.size(), s, lambda);
     }*/
 
@@ -1041,22 +1049,16 @@ void findSeparatorsGreedy(Graph* G, std::vector<std::unordered_set<int>>& clique
                     maxFound, propositionMinimum, separators, 0, 0, 1, separatorsOrder);
 }
 
-void findSeparatorsGreedyFunction(int graphsCount, std::string line) {
+void findSeparatorsGreedyFunction(int graphsCount, Graph& GraphValue, std::string line) {
     size_t c = 4;
     int propositionMinimum = 8;
 
-    Graph GraphValue = Graph::parse_graph6(line);
+    GraphValue.assign_graph6(line);
     Graph* G = &GraphValue;
     std::cout << "Graph "<<graphsCount<<": "<<line<<" with n="<<G->n()<<" c="<<c<<"\n";
 
-    // get all cliques
-    auto cliqueInfo = G->getMaximalCliques(999999);
-
-    // create sets out of the cliques
-    std::vector<std::unordered_set<int>> cliques = {};
-    for(auto& clique : cliqueInfo.cliqueList) {
-        cliques.push_back(std::unordered_set<int>(clique.begin(), clique.end()));
-    }
+    // get all cliques as sets
+    std::vector<std::unordered_set<int>> cliques = cliqueSetsGet(G, {.maxCliques = 0, .minCliques = c});
     
     // lambda to receive the indices and call the solver function
     auto lambda = [&propositionMinimum,G,&cliques](size_t, std::vector<size_t> indices) {
@@ -1070,8 +1072,8 @@ void findSeparatorsGreedyFunction(int graphsCount, std::string line) {
     };
 
     // try ALL subsets of cliques: size at least 3, since for 2 cliques we need at most 2 separators
-    // if(cliqueInfo.cliqueList.size() < 3) return;
-    /*for(size_t s = 3; s <= cliqueInfo.cliqueList.size(); ++s) {
+    // if(cliques.size() < 3) return;
+    /*for(size_t s = 3; s <= cliques.size(); ++s) {
         SubsetsOfSizeLoop(cliques.size(), s, lambda);
     }*/
 
@@ -1229,22 +1231,16 @@ void findExampleWhereSeparatorPropertyMinimal(int graphsCount, Graph* G, std::ve
 }
 
 // assume the given graph IS a forbidden induced subgraph - check if minimal
-void findExampleWhereSeparatorPropertyMinimal(int graphsCount, std::string line) {
+void findExampleWhereSeparatorPropertyMinimal(int graphsCount, Graph& GraphValue, std::string line) {
     size_t c = 4;
     int propositionMinimum = 6;
 
-    Graph GraphValue = Graph::parse_graph6(line);
+    GraphValue.assign_graph6(line);
     Graph* G = &GraphValue;
     // std::cout << "Graph "<<graphsCount<<": "<<line<<" with n="<<G->n()<<" c="<<c<<"\n";
 
-    // get all cliques
-    auto cliqueInfo = G->getMaximalCliques(999999);
-
-    // create sets out of the cliques
-    std::vector<std::unordered_set<int>> cliques = {};
-    for(auto& clique : cliqueInfo.cliqueList) {
-        cliques.push_back(std::unordered_set<int>(clique.begin(), clique.end()));
-    }
+    // get all cliques as sets
+    std::vector<std::unordered_set<int>> cliques = cliqueSetsGet(G, {.maxCliques = 0, .minCliques = c});
     
     // lambda to receive the indices and call the solver function
     auto lambda = [graphsCount, &propositionMinimum,G,&cliques](size_t, std::vector<size_t> indices) {
@@ -1258,8 +1254,8 @@ void findExampleWhereSeparatorPropertyMinimal(int graphsCount, std::string line)
     };
 
     // try ALL subsets of cliques: size at least 3, since for 2 cliques we need at most 2 separators
-    // if(cliqueInfo.cliqueList.size() < 3) return;
-    /*for(size_t s = 3; s <= cliqueInfo.cliqueList.size(); ++s) {
+    // if(cliques.size() < 3) return;
+    /*for(size_t s = 3; s <= cliques.size(); ++s) {
         SubsetsOfSizeLoop(cliques.size(), s, lambda);
     }*/
 
@@ -1466,23 +1462,17 @@ void iterativeTwoVerticesPropositionOnCliques(int graphsCount, Graph* G,
 }
 
 // if there is an outside vertex, can we just find separators for the other cliques, then there must exist an outside vertex where we only have to add 2?
-void outsideVertexProposition(int graphsCount, std::string line) {
+void outsideVertexProposition(int graphsCount, Graph& GraphValue, std::string line) {
     size_t c = 4;
     int propositionMinimum = 6;
     int propositionMinimum1Smaller = 4;
 
-    Graph GraphValue = Graph::parse_graph6(line);
+    GraphValue.assign_graph6(line);
     Graph* G = &GraphValue;
     // std::cout << "Graph "<<graphsCount<<": "<<line<<" with n="<<G->n()<<" c="<<c<<"\n";
 
-    // get all cliques
-    auto cliqueInfo = G->getMaximalCliques(999999);
-
-    // create sets out of the cliques
-    std::vector<std::unordered_set<int>> cliques = {};
-    for(auto& clique : cliqueInfo.cliqueList) {
-        cliques.push_back(std::unordered_set<int>(clique.begin(), clique.end()));
-    }
+    // get all cliques as sets
+    std::vector<std::unordered_set<int>> cliques = cliqueSetsGet(G, {.maxCliques = 0, .minCliques = c});
     
     // lambda to receive the indices and call the solver function
     auto lambda = [graphsCount, &propositionMinimum, &propositionMinimum1Smaller,G,&cliques](size_t, std::vector<size_t> indices) {
@@ -1557,6 +1547,8 @@ int main(int argc, char* argv[]) {
 
             // run actual program
             int numberOfCliquesToSeparatorSize = 0;
+            // reused for every line: no allocation per graph
+            Graph GraphValue = Graph(0);
             while(fgets(buffer, sizeof(buffer), stream)) {
                 std::string msg(buffer);
                 if(msg.empty()) continue;
@@ -1572,15 +1564,15 @@ int main(int argc, char* argv[]) {
                 if(!line.empty() && line.back() == '\n')
                     line.pop_back();
 
-                // testThreeCliquesOverlapping(graphsCount, line);
-                // testFourCliquesOverlapping(graphsCount, line);
-                // testThreeCliquesSeparator(graphsCount, line);
-                // lookForGraphWhereEveryVertexIsInHighAmountOfCliques(graphsCount, line);
-                // cliquesMinimumNumberOfCliquesPerVertex(graphsCount, line, numberOfCliquesWithCHalf);
-                cliqueSeparatorWorstCase(graphsCount, line, numberOfCliquesToSeparatorSize);
-                // findSeparatorsGreedyFunction(graphsCount, line);
-                // findExampleWhereSeparatorPropertyMinimal(graphsCount, line);
-                outsideVertexProposition(graphsCount, line);
+                // testThreeCliquesOverlapping(graphsCount, GraphValue, line);
+                // testFourCliquesOverlapping(graphsCount, GraphValue, line);
+                // testThreeCliquesSeparator(graphsCount, GraphValue, line);
+                // lookForGraphWhereEveryVertexIsInHighAmountOfCliques(graphsCount, GraphValue, line);
+                // cliquesMinimumNumberOfCliquesPerVertex(GraphValue, line, numberOfCliquesWithCHalf);
+                cliqueSeparatorWorstCase(graphsCount, GraphValue, line, numberOfCliquesToSeparatorSize);
+                // findSeparatorsGreedyFunction(graphsCount, GraphValue, line);
+                // findExampleWhereSeparatorPropertyMinimal(graphsCount, GraphValue, line);
+                outsideVertexProposition(graphsCount, GraphValue, line);
             }
 
             std::cout << "worker id="<<w<<" finished: needed separators found="<< numberOfCliquesToSeparatorSize<<"\n";
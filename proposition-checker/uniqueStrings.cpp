@@ -2,64 +2,97 @@
 Receives strings on std::cin and then prints the unique strings
 
 Usage:
-uniqueStrings [-s] [-q]
+uniqueStrings [-s] [-q] [-m] [-b MB [-o] [-t directory]] [-j threads [-u]]
 
--s: use if the input is guaranteed to be only short strings - the strings will not be hashed which can be faster. Otherwise, the strings are hashed.
+The strings are kept exactly in a StringSet (graph6 strings packed with 6 bits per character), no hash collision drops a string.
+-s: kept for old scripts, short strings are stored like all other strings.
 -q: print the outputs in quotes and a comma before the new line.
+-m: print the number of unique strings and the memory of the set to stderr at the end.
+-b: memory budget in MB. Sorted runs are written to temporary files when it is reached and merged at the end (see ExternalUnique.h).
+    The strings are printed at the end, sorted.
+-o: with -b, print the strings in the order of their first line instead of sorted.
+-t: with -b, directory of the temporary files (default: $TMPDIR or /tmp).
+-j: dedup on this many shard threads, the lines are routed by hash (0: one per hardware thread, see ParallelUnique.h).
+    The output is in the order of the input like with one thread. Not used with -b.
+-u: with -j, print the lines as the shards find them (not in the order of the input).
 */
 
 #include <iostream>
 #include <string>
-#include <unordered_set>
+#include <cstdlib>
+#include "StringSet.h"
+#include "ExternalUnique.h"
+#include "ParallelUnique.h"
 
 int main(int argc, char* argv[]) {
     std::string line;
 
-    // set of strings found
-    std::unordered_set<std::string> foundStrings = std::unordered_set<std::string>(100);
-    // set of hashes found
-    std::unordered_set<size_t> foundHashes = std::unordered_set<size_t>(100);
-
-    // hasher in case the input is long strings
-    std::hash<std::string> hasher;
-
     // parse options
     bool printWithQuotes = false;
-    bool shortStrings = false;
+    bool printMemory = false;
+    size_t memoryBudget = 0;
+    bool firstSeenOrder = false;
+    int threads = -1;
+    bool unordered = false;
+    std::string directory = std::getenv("TMPDIR") != nullptr ? std::getenv("TMPDIR") : "/tmp";
     for(int i=1; i<argc; ++i) {
         std::string option = argv[i];
         if(option == "-q") printWithQuotes = true;
-        if(option == "-s") shortStrings = true;
+        if(option == "-m") printMemory = true;
+        if(option == "-b" && i+1 < argc) memoryBudget = std::stoull(argv[++i]) << 20;
+        if(option == "-o") firstSeenOrder = true;
+        if(option == "-t" && i+1 < argc) directory = argv[++i];
+        if(option == "-j" && i+1 < argc) threads = std::stoi(argv[++i]);
+        if(option == "-u") unordered = true;
     }
 
-    // read inputs and print
-    while (std::getline(std::cin, line)) {
-        if (line.empty()) continue;
-
-        // check if we already found this string
-        if(shortStrings) {
-            // check and save the string itself
-            if(foundStrings.find(line) != foundStrings.end()) {
-                continue;
-            }
-            foundStrings.insert(line);
-        } else {
-            // check a hash
-            auto hash = hasher(line);
-            if(foundHashes.find(hash) != foundHashes.end()) {
-                continue;
-            }
-            foundHashes.insert(hash);
-        }
-
-        // print immediately
+    auto print = [printWithQuotes](const std::string& line) {
         if(printWithQuotes) {
             std::cout << "\"" << line << "\",\n";
         }
         else {
             std::cout << line << "\n";
         }
+    };
+
+    // memory budget: sorted runs on disk, printed at the end
+    if(memoryBudget > 0) {
+        ExternalUnique unique = ExternalUnique(memoryBudget, directory, firstSeenOrder);
+        while (std::getline(std::cin, line)) {
+            if (line.empty()) continue;
+            unique.add(line);
+        }
+        unique.finish(print);
+        if(printMemory) std::cerr << unique.runsWritten << " runs written to " << directory << "\n";
+        return 0;
+    }
+
+    // shards on several threads
+    if(threads >= 0) {
+        ParallelUnique unique = ParallelUnique(threads, !unordered);
+        unique.run(std::cin, print);
+        if(printMemory) {
+            std::cerr << unique.size() << " unique strings in " << unique.memory() << " bytes on " << unique.shards() << " shards\n";
+        }
+        return 0;
     }
 
+    // set of strings found
+    StringSet foundStrings = StringSet(1 << 16);
+
+    // read inputs and print
+    while (std::getline(std::cin, line)) {
+        if (line.empty()) continue;
+
+        // check and save the string if we did not find it yet
+        if(!foundStrings.insert(line)) continue;
+
+        // print immediately
+        print(line);
+    }
+
+    if(printMemory) {
+        std::cerr << foundStrings.size() << " unique strings in " << foundStrings.memory() << " bytes\n";
+    }
     return 0;
 }